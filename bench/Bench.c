@@ -0,0 +1,611 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <GenericDynvec.h>
+#include <Tokenizer.h>
+#include <Wordmap.h>
+#include <Wordlookup.h>
+
+#define BENCH_BOOK "padre_amaro.txt" // Livro utilizado nos benchmarks de strings
+
+// Estrutura com o mesmo formato da 'word' de Main.c
+typedef struct Record
+{
+    const char *word;
+    size_t times;
+} record;
+
+// Comparação genérica (ponteiros para void)
+static int record_comp(const void *key, const void *elem)
+{
+    size_t a = ((const record *)key)->times, b = ((const record *)elem)->times;
+    return (a > b) - (a < b);
+}
+
+// Comparação genérica de strings (elementos do vetor são 'char *')
+static int string_comp(const void *key, const void *elem)
+{
+    return strcmp(*(const char *const *)key, *(const char *const *)elem);
+}
+
+// Comparação especializada (inlinada pelo DYNVEC_DEFINE_SORT)
+static inline int record_cmp(const record *key, const record *elem)
+{
+    return (key->times > elem->times) - (key->times < elem->times);
+}
+
+DYNVEC_DEFINE(record, record_vec)
+DYNVEC_DEFINE_SORT(record, record_vec, record_cmp)
+
+/*-------------------------------------------------------
+   Funções auxiliares
+-------------------------------------------------------*/
+
+// Retorna o tempo atual do relógio monotônico em segundos
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Gerador pseudoaleatório simples (xorshift), para que as entradas sejam reprodutíveis
+static uint64_t next_random(uint64_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Imprime uma linha de resultado
+static void report(const char *name, size_t n, double generic, double typed)
+{
+    printf("%-24s n=%-9zu generic %9.3f ms   typed %9.3f ms   speedup %5.2fx\n",
+           name, n, generic * 1e3, typed * 1e3, generic / typed);
+}
+
+/*-------------------------------------------------------
+   Benchmarks
+-------------------------------------------------------*/
+
+// Compara dynvec_push com o push especializado
+static void bench_push(size_t n)
+{
+    record item = {NULL, 0};
+
+    double start = now();
+    dynvec *generic = dynvec_create(sizeof(record));
+    for (size_t i = 0; i < n; i++)
+    {
+        item.times = i;
+        dynvec_push(generic, &item);
+    }
+    double generic_time = now() - start;
+
+    start = now();
+    record_vec *typed = record_vec_create();
+    for (size_t i = 0; i < n; i++)
+    {
+        item.times = i;
+        record_vec_push(typed, item);
+    }
+    double typed_time = now() - start;
+
+    report("push", n, generic_time, typed_time);
+    dynvec_free(generic);
+    record_vec_free(typed);
+}
+
+// Função auxiliar: cria 'rounds' vetores com o alocador, cada um com 'items' elementos e a seleção dos
+// 10 maiores, e os libera (o padrão das consultas repetidas de ranking). Retorna o tempo em segundos
+static double churn(const dynvec_allocator *allocator, size_t rounds, size_t items)
+{
+    double start = now();
+    for (size_t r = 0; r < rounds; r++)
+    {
+        dynvec *vec = dynvec_create_with(sizeof(record), allocator);
+        for (size_t i = 0; i < items; i++)
+        {
+            record item = {NULL, (i * 2654435761u) % items};
+            dynvec_push(vec, &item);
+        }
+        dynvec *top = dynvec_top_k(vec, 10, record_comp);
+        dynvec_free(top);
+        dynvec_free(vec);
+    }
+    return now() - start;
+}
+
+// Compara o alocador do sistema com o pool em vetores criados e liberados em um laço, e inserções e
+// remoções alternadas perto do limite de redução da capacidade
+static void bench_allocator(size_t rounds)
+{
+    dynvec_pool *pool = dynvec_pool_create();
+    double system_time = churn(&dynvec_system_allocator, rounds, 32);
+    double pool_time = churn(dynvec_pool_allocator(pool), rounds, 32);
+    printf("%-24s n=%-9zu system  %9.3f ms   pool  %9.3f ms   speedup %5.2fx\n",
+           "create/push/free", rounds, system_time * 1e3, pool_time * 1e3, system_time / pool_time);
+    dynvec_pool_free(pool);
+
+    dynvec *vec = dynvec_create(sizeof(record));
+    record item = {NULL, 0};
+    for (size_t i = 0; i < 1024; i++)
+        dynvec_push(vec, &item);
+    size_t before = dynvec_capacity(vec);
+    double start = now();
+    for (size_t r = 0; r < rounds; r++)
+    {
+        // Desce até perto de 1/8 da capacidade e volta: nenhuma operação realoca
+        for (size_t i = 0; i < 1024 - 160; i++)
+            dynvec_pop_into(vec, NULL);
+        for (size_t i = 0; i < 1024 - 160; i++)
+            dynvec_push(vec, &item);
+    }
+    printf("%-24s n=%-9zu %9.3f ms   capacidade %zu -> %zu\n", "pop/push alternados", rounds,
+           (now() - start) * 1e3, before, dynvec_capacity(vec));
+    dynvec_free(vec);
+}
+
+// Funções dos benchmarks das versões paralelas (registros com 'times' pseudoaleatório)
+static void record_touch(void *elem)
+{
+    record *r = (record *)elem;
+    r->times = r->times * 31 + 7;
+}
+
+static void record_sum(void *acc, void *elem)
+{
+    *(size_t *)acc += ((record *)elem)->times;
+}
+
+static void sum_combine(void *acc, const void *partial)
+{
+    *(size_t *)acc += *(const size_t *)partial;
+}
+
+static bool record_odd(void *elem)
+{
+    return ((record *)elem)->times & 1;
+}
+
+static bool record_missing(void *elem)
+{
+    return ((record *)elem)->word != NULL;
+}
+
+// Imprime uma linha de resultado das versões paralelas
+static void report_parallel(const char *name, size_t n, double sequential, double parallel, int threads)
+{
+    printf("%-24s n=%-9zu sequential %9.3f ms   parallel(%d) %9.3f ms   speedup %5.2fx\n",
+           name, n, sequential * 1e3, threads, parallel * 1e3, sequential / parallel);
+}
+
+// Compara map, fold, filter e exists sequenciais com as versões paralelas (mesmo pool em todas)
+static void bench_parallel(size_t n, threadpool *pool)
+{
+    dynvec *vec = dynvec_create(sizeof(record));
+    uint64_t state = 88172645463325252ULL;
+    for (size_t i = 0; i < n; i++)
+    {
+        record item = {NULL, next_random(&state) % 1000000};
+        dynvec_push(vec, &item);
+    }
+    int threads = threadpool_threads(pool);
+
+    double start = now();
+    dynvec_map(vec, record_touch);
+    double sequential = now() - start;
+    start = now();
+    dynvec_map_parallel(vec, record_touch, pool);
+    report_parallel("map", n, sequential, now() - start, threads);
+
+    size_t seq_sum = 0, par_sum = 0, zero = 0;
+    start = now();
+    dynvec_fold_left(vec, &seq_sum, record_sum);
+    sequential = now() - start;
+    start = now();
+    dynvec_fold_parallel(vec, &par_sum, sizeof(size_t), &zero, record_sum, sum_combine, pool);
+    report_parallel("fold (soma)", n, sequential, now() - start, threads);
+
+    start = now();
+    dynvec *seq_filtered = dynvec_filter(vec, record_odd);
+    sequential = now() - start;
+    start = now();
+    dynvec *par_filtered = dynvec_filter_parallel(vec, record_odd, pool);
+    report_parallel("filter (metade)", n, sequential, now() - start, threads);
+
+    // Nenhum elemento satisfaz o predicado: o vetor é percorrido inteiro
+    start = now();
+    bool seq_found = dynvec_exists(vec, record_missing);
+    sequential = now() - start;
+    start = now();
+    bool par_found = dynvec_exists_parallel(vec, record_missing, pool);
+    report_parallel("exists (nenhum)", n, sequential, now() - start, threads);
+
+    if (seq_sum != par_sum || seq_found != par_found || !seq_filtered || !par_filtered ||
+        dynvec_length(seq_filtered) != dynvec_length(par_filtered) ||
+        memcmp(dynvec_get(seq_filtered, 0), dynvec_get(par_filtered, 0), dynvec_length(seq_filtered) * sizeof(record)) != 0)
+        printf("ERRO: resultados paralelos diferentes dos sequenciais\n");
+    dynvec_free(seq_filtered);
+    dynvec_free(par_filtered);
+    dynvec_free(vec);
+}
+
+// Formatos de entrada dos benchmarks de ordenação
+typedef enum Pattern
+{
+    PATTERN_RANDOM,  // Valores aleatórios
+    PATTERN_SORTED,  // Já ordenado
+    PATTERN_REVERSED // Ordem inversa
+} pattern;
+
+// Compara quicksort_dynvec_three_way com o sort especializado, com 'distinct' valores distintos
+static void bench_sort(size_t n, size_t distinct, pattern kind)
+{
+    static const char *kind_names[] = {"random", "sorted", "reversed"};
+    uint64_t state = 88172645463325252ULL;
+    dynvec *generic = dynvec_create(sizeof(record));
+    record_vec *typed = record_vec_create();
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t key = (kind == PATTERN_RANDOM) ? next_random(&state) % distinct : (kind == PATTERN_SORTED) ? i : n - i;
+        record item = {NULL, key};
+        dynvec_push(generic, &item);
+        record_vec_push(typed, item);
+    }
+
+    double start = now();
+    quicksort_dynvec_three_way(generic, record_comp, 0, n - 1);
+    double generic_time = now() - start;
+
+    start = now();
+    record_vec_sort(typed);
+    double typed_time = now() - start;
+
+    // Confere se as duas ordenações produziram a mesma sequência de chaves
+    for (size_t i = 0; i < n; i++)
+    {
+        if (((record *)dynvec_get(generic, i))->times != typed->data[i].times)
+        {
+            fprintf(stderr, "sort mismatch at %zu\n", i);
+            exit(1);
+        }
+    }
+
+    char name[64];
+    if (kind == PATTERN_RANDOM)
+        snprintf(name, sizeof(name), "sort (%zu distinct)", distinct);
+    else
+        snprintf(name, sizeof(name), "sort (%s)", kind_names[kind]);
+    report(name, n, generic_time, typed_time);
+    dynvec_free(generic);
+    record_vec_free(typed);
+}
+
+// Compara mergesort_dynvec com mergesort_dynvec_parallel; as chaves se repetem para conferir a estabilidade
+static void bench_mergesort(size_t n, int threads)
+{
+    uint64_t state = 88172645463325252ULL;
+    dynvec *sequential = dynvec_create(sizeof(record));
+    dynvec *parallel = dynvec_create(sizeof(record));
+    for (size_t i = 0; i < n; i++)
+    {
+        record item = {(const char *)(uintptr_t)i, next_random(&state) % (n / 4 + 1)};
+        dynvec_push(sequential, &item);
+        dynvec_push(parallel, &item);
+    }
+    void *temp = malloc(n * sizeof(record));
+
+    double start = now();
+    mergesort_dynvec(sequential, temp, record_comp, 0, n);
+    double sequential_time = now() - start;
+
+    start = now();
+    mergesort_dynvec_parallel(parallel, temp, record_comp, 0, n, threads);
+    double parallel_time = now() - start;
+
+    // O resultado deve ser idêntico byte a byte (mesma ordem dos empates)
+    for (size_t i = 0; i < n; i++)
+    {
+        if (memcmp(dynvec_get(sequential, i), dynvec_get(parallel, i), sizeof(record)) != 0)
+        {
+            fprintf(stderr, "parallel mergesort mismatch at %zu\n", i);
+            exit(1);
+        }
+    }
+
+    printf("%-24s n=%-9zu serial   %9.3f ms   %2d threads %6.3f ms   speedup %5.2fx\n",
+           "mergesort", n, sequential_time * 1e3, threads, parallel_time * 1e3, sequential_time / parallel_time);
+    free(temp);
+    dynvec_free(sequential);
+    dynvec_free(parallel);
+}
+
+// Comparação genérica pela chave de 8 bytes no início de um elemento de qualquer largura
+static int key_comp(const void *key, const void *elem)
+{
+    uint64_t a, b;
+    memcpy(&a, key, sizeof(a));
+    memcpy(&b, elem, sizeof(b));
+    return (a > b) - (a < b);
+}
+
+// Mede as primitivas genéricas com elementos de 'width' bytes (chave nos 8 primeiros bytes):
+// n pushes, 200 inserções em posições aleatórias de um vetor com n elementos, e as duas ordenações
+static void bench_primitives(size_t n, size_t width)
+{
+    const size_t inserts = 200;
+    uint64_t state = 0x2545f4914f6cdd1dULL ^ (n * width);
+    char *item = calloc(1, width);
+
+    double start = now();
+    dynvec *vec = dynvec_create(width);
+    for (size_t i = 0; i < n; i++)
+    {
+        uint64_t key = next_random(&state);
+        memcpy(item, &key, sizeof(key));
+        dynvec_push(vec, item);
+    }
+    double push_time = now() - start;
+
+    dynvec *copy = dynvec_create(width);
+    for (size_t i = 0; i < n; i++)
+        dynvec_push(copy, dynvec_get(vec, i));
+
+    start = now();
+    for (size_t i = 0; i < inserts; i++)
+        dynvec_insert(copy, next_random(&state) % (dynvec_length(copy) + 1), item);
+    double insert_time = now() - start;
+    dynvec_free(copy);
+
+    copy = dynvec_create(width);
+    for (size_t i = 0; i < n; i++)
+        dynvec_push(copy, dynvec_get(vec, i));
+
+    start = now();
+    quicksort_dynvec_three_way(vec, key_comp, 0, n - 1);
+    double quicksort_time = now() - start;
+
+    void *temp = malloc(n * width);
+    start = now();
+    mergesort_dynvec(copy, temp, key_comp, 0, n);
+    double mergesort_time = now() - start;
+
+    // As duas ordenações devem produzir a mesma sequência de chaves
+    for (size_t i = 0; i < n; i++)
+    {
+        if (key_comp(dynvec_get(vec, i), dynvec_get(copy, i)) != 0)
+        {
+            fprintf(stderr, "primitive sort mismatch at %zu (width %zu)\n", i, width);
+            exit(1);
+        }
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "primitives (%zu bytes)", width);
+    printf("%-24s n=%-9zu push %7.1f ns/op   insert %9.1f ns/op   quicksort %8.3f ms   mergesort %8.3f ms\n",
+           name, n, push_time / n * 1e9, insert_time / inserts * 1e9, quicksort_time * 1e3, mergesort_time * 1e3);
+    free(item);
+    free(temp);
+    dynvec_free(vec);
+    dynvec_free(copy);
+}
+
+// Carrega todas as palavras do livro em um vetor de 'char *', repetindo o livro 'copies' vezes
+static dynvec *load_book_words(int copies)
+{
+    dynvec *words = dynvec_create(sizeof(char *));
+    for (int c = 0; c < copies; c++)
+    {
+        tokenizer *tk = tokenizer_open(BENCH_BOOK);
+        if (!tk)
+        {
+            perror("Error opening " BENCH_BOOK);
+            exit(1);
+        }
+        token tok;
+        while (tokenizer_next(tk, &tok))
+        {
+            char *copy = strndup(tok.ptr, tok.len);
+            dynvec_push(words, &copy);
+        }
+        tokenizer_close(tk);
+    }
+    return words;
+}
+
+// Copia os ponteiros de um vetor de strings para um novo vetor
+static dynvec *copy_strings(dynvec *words)
+{
+    dynvec *copy = dynvec_create(sizeof(char *));
+    for (size_t i = 0; i < dynvec_length(words); i++)
+        dynvec_push(copy, dynvec_get(words, i));
+    return copy;
+}
+
+// Compara quicksort_dynvec_three_way + string_comp com o multikey quicksort sobre as palavras do livro
+static void bench_string_sort(int copies)
+{
+    dynvec *words = load_book_words(copies);
+    dynvec *generic = copy_strings(words);
+    dynvec *multikey = copy_strings(words);
+    size_t n = dynvec_length(words);
+
+    double start = now();
+    quicksort_dynvec_three_way(generic, string_comp, 0, n - 1);
+    double generic_time = now() - start;
+
+    start = now();
+    dynvec_sort_strings(multikey);
+    double multikey_time = now() - start;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (strcmp(*(char **)dynvec_get(generic, i), *(char **)dynvec_get(multikey, i)) != 0)
+        {
+            fprintf(stderr, "string sort mismatch at %zu\n", i);
+            exit(1);
+        }
+    }
+
+    printf("%-24s n=%-9zu 3-way    %9.3f ms   multikey %8.3f ms   speedup %5.2fx\n",
+           "sort strings (book)", n, generic_time * 1e3, multikey_time * 1e3, generic_time / multikey_time);
+
+    for (size_t i = 0; i < n; i++)
+        free(*(char **)dynvec_get(words, i));
+    dynvec_free(words);
+    dynvec_free(generic);
+    dynvec_free(multikey);
+}
+
+// Compara a velocidade do tokenizador sem e com normalização (--fold) sobre o livro repetido 'copies' vezes
+static void bench_fold(int copies)
+{
+    tokenizer *tk = tokenizer_open(BENCH_BOOK);
+    size_t book_size;
+    const char *book = tk ? tokenizer_buffer(tk, &book_size) : NULL;
+    if (!book)
+    {
+        perror("Error opening " BENCH_BOOK);
+        exit(1);
+    }
+    size_t size = book_size * copies;
+    char *data = malloc(size);
+    for (int c = 0; c < copies; c++)
+        memcpy(data + c * book_size, book, book_size);
+    tokenizer_close(tk);
+
+    double times[2];
+    size_t tokens[2] = {0, 0};
+    for (int fold = 0; fold < 2; fold++)
+    {
+        tokenizer_set_fold(fold);
+        double start = now();
+        tk = tokenizer_open_buffer(data, size);
+        token tok;
+        while (tokenizer_next(tk, &tok))
+            tokens[fold]++;
+        tokenizer_close(tk);
+        times[fold] = now() - start;
+    }
+    tokenizer_set_fold(false);
+
+    printf("%-24s n=%-9zu bytes %7.1f MB/s   fold %7.1f MB/s   (%zu / %zu tokens)\n",
+           "tokenize (book)", size, size / times[0] / 1e6, size / times[1] / 1e6, tokens[0], tokens[1]);
+    free(data);
+}
+
+// Compara três formas de responder "quantas vezes a palavra X aparece" em um vocabulário de
+// 'vocabulary' palavras aleatórias: dynvec_bsearch (vetor ordenado + string_comp), wordmap_get
+// (tabela hash) e wordlookup_count (layout Eytzinger). 1 em cada 8 consultas não existe.
+static void bench_lookup(size_t vocabulary)
+{
+    const size_t queries = 2000000;
+    uint64_t state = 0x5eed + vocabulary;
+    wordmap *map = wordmap_create();
+    char word[24];
+
+    while (wordmap_length(map) < vocabulary)
+    {
+        size_t len = 3 + next_random(&state) % 12;
+        for (size_t j = 0; j < len; j++)
+            word[j] = 'a' + next_random(&state) % 26;
+        wordmap_add(map, word, len, 1 + next_random(&state) % 1000);
+    }
+
+    // Vetor ordenado com os handles das palavras (para dynvec_bsearch) e a estrutura Eytzinger
+    dynvec *sorted = dynvec_create(sizeof(char *));
+    dynvec *entries = wordmap_entries(map);
+    for (size_t i = 0; i < vocabulary; i++)
+        dynvec_push(sorted, &((wordmap_entry *)dynvec_get(entries, i))->word);
+    dynvec_sort_strings(sorted);
+    wordlookup *wl = wordlookup_create(map);
+
+    // Consultas: palavras existentes em ordem aleatória, com algumas palavras trocadas por inexistentes
+    char **keys = malloc(queries * sizeof(char *));
+    size_t *lens = malloc(queries * sizeof(size_t));
+    for (size_t i = 0; i < queries; i++)
+    {
+        const char *existing = ((wordmap_entry *)dynvec_get(entries, next_random(&state) % vocabulary))->word;
+        keys[i] = strdup(existing);
+        lens[i] = strlen(keys[i]);
+        if (i % 8 == 0)
+            keys[i][0] = 'A'; // Letras maiúsculas nunca são geradas
+    }
+
+    size_t found_bsearch = 0, found_hash = 0, found_eytzinger = 0;
+    double start = now();
+    for (size_t i = 0; i < queries; i++)
+        found_bsearch += dynvec_bsearch(sorted, &keys[i], string_comp) != (size_t)-1;
+    double bsearch_time = now() - start;
+
+    start = now();
+    for (size_t i = 0; i < queries; i++)
+        found_hash += wordmap_get(map, keys[i], lens[i]) != 0;
+    double hash_time = now() - start;
+
+    start = now();
+    for (size_t i = 0; i < queries; i++)
+        found_eytzinger += wordlookup_count(wl, keys[i], lens[i]) != 0;
+    double eytzinger_time = now() - start;
+
+    if (found_bsearch != found_hash || found_hash != found_eytzinger)
+    {
+        fprintf(stderr, "lookup mismatch: %zu %zu %zu\n", found_bsearch, found_hash, found_eytzinger);
+        exit(1);
+    }
+
+    printf("%-24s n=%-9zu bsearch %6.1f ns   hash %6.1f ns   eytzinger %6.1f ns   speedup %5.2fx\n",
+           "lookup (per query)", vocabulary, bsearch_time / queries * 1e9, hash_time / queries * 1e9,
+           eytzinger_time / queries * 1e9, bsearch_time / eytzinger_time);
+
+    for (size_t i = 0; i < queries; i++)
+        free(keys[i]);
+    free(keys);
+    free(lens);
+    wordlookup_free(wl);
+    dynvec_free(sorted);
+    wordmap_free(map);
+}
+
+int main(void)
+{
+    size_t sizes[] = {10000, 100000, 1000000};
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = (cpus > 1) ? (int)cpus : 4;
+
+    size_t widths[] = {8, 32, 128};
+    for (size_t w = 0; w < sizeof(widths) / sizeof(widths[0]); w++)
+    {
+        for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+            bench_primitives(sizes[i], widths[w]);
+    }
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+        bench_push(sizes[i]);
+    bench_allocator(100000);
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        bench_sort(sizes[i], sizes[i], PATTERN_RANDOM);
+        bench_sort(sizes[i], 100, PATTERN_RANDOM);
+        bench_sort(sizes[i], sizes[i], PATTERN_SORTED);
+        bench_sort(sizes[i], sizes[i], PATTERN_REVERSED);
+    }
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+        bench_mergesort(sizes[i], threads);
+    threadpool *pool = threadpool_create(threads);
+    for (size_t i = 0; pool && i < sizeof(sizes) / sizeof(sizes[0]); i++)
+        bench_parallel(sizes[i] * 4, pool);
+    threadpool_free(pool);
+    bench_string_sort(1);
+    bench_string_sort(8);
+    bench_fold(16);
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+        bench_lookup(sizes[i]);
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+/*
+ * Gerador de textos sintéticos para os benchmarks: as palavras seguem uma distribuição de Zipf
+ * (a k-ésima palavra mais usada aparece com frequência proporcional a 1/k^s), como em textos reais.
+ * A saída é sempre a mesma para os mesmos argumentos.
+ *
+ * Uso: zipf <tamanho> <arquivo> [vocabulário] [expoente]
+ *   tamanho: bytes a serem gerados, com sufixo opcional K, M ou G
+ */
+
+#define DEFAULT_VOCABULARY 100000     // Quantidade padrão de palavras distintas
+#define DEFAULT_EXPONENT 1.0          // Expoente padrão da distribuição
+#define MAX_WORD 16                   // Tamanho máximo de uma palavra
+#define WORDS_PER_LINE 12             // Palavras por linha
+#define WORD_MULTIPLIER 2654435761ULL // Multiplicador primo com 26 que embaralha as palavras
+
+// Gerador pseudoaleatório simples (xorshift), para que a saída seja reprodutível
+static uint64_t next_random(uint64_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Lê um tamanho em bytes com sufixo opcional (K, M ou G). Retorna false se for inválido
+static bool parse_size(const char *text, size_t *size)
+{
+    char *end;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (end == text)
+        return false;
+    switch (*end)
+    {
+    case 'G':
+    case 'g':
+        value *= 1024;
+        /* fall through */
+    case 'M':
+    case 'm':
+        value *= 1024;
+        /* fall through */
+    case 'K':
+    case 'k':
+        value *= 1024;
+        end++;
+        break;
+    }
+    *size = (size_t)value;
+    return *end == '\0' && value > 0;
+}
+
+// Função auxiliar: posição da primeira probabilidade acumulada maior ou igual a 'u'
+static size_t sample(const double *cdf, size_t length, double u)
+{
+    size_t low = 0, high = length - 1;
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        if (cdf[mid] < u)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t size;
+    if (argc < 3 || !parse_size(argv[1], &size))
+    {
+        fprintf(stderr, "Uso: %s <tamanho> <arquivo> [vocabulário] [expoente]\n", argv[0]);
+        return -1;
+    }
+    size_t vocabulary = (argc > 3) ? strtoull(argv[3], NULL, 10) : DEFAULT_VOCABULARY;
+    double exponent = (argc > 4) ? atof(argv[4]) : DEFAULT_EXPONENT;
+    if (vocabulary == 0 || exponent <= 0)
+    {
+        fprintf(stderr, "O vocabulário e o expoente devem ser positivos\n");
+        return -1;
+    }
+
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    char *words = malloc(vocabulary * (MAX_WORD + 1));
+    unsigned char *lens = malloc(vocabulary);
+    double *cdf = malloc(vocabulary * sizeof(double));
+    FILE *out = fopen(argv[2], "w");
+    if (!words || !lens || !cdf || !out)
+    {
+        perror("Error creating corpus");
+        return -1;
+    }
+
+    // Vocabulário: palavras de 1 a MAX_WORD letras minúsculas. Como nos textos reais, as palavras
+    // mais usadas são as mais curtas: os tamanhos sorteados são distribuídos em ordem crescente.
+    // Um tamanho não recebe mais palavras do que existem com aquele número de letras
+    size_t length_count[MAX_WORD + 2] = {0};
+    for (size_t k = 0; k < vocabulary; k++)
+        length_count[1 + next_random(&state) % 4 + next_random(&state) % 5 + next_random(&state) % (MAX_WORD - 8)]++;
+    for (size_t len = 1; len < MAX_WORD; len++)
+    {
+        uint64_t available = 1;
+        for (size_t j = 0; j < len && j < 13; j++)
+            available *= 26;
+        if (length_count[len] > available)
+        {
+            length_count[len + 1] += length_count[len] - available;
+            length_count[len] = available;
+        }
+    }
+
+    // A i-ésima palavra de cada tamanho são os dígitos em base 26 de i * WORD_MULTIPLIER (mod 26^tamanho):
+    // como o multiplicador é primo com 26, as palavras são distintas e parecem aleatórias
+    for (size_t k = 0, len = 1, i = 0; k < vocabulary; k++, i++)
+    {
+        while (length_count[len] == 0)
+            len++, i = 0;
+        length_count[len]--;
+        uint64_t digits = i * WORD_MULTIPLIER;
+        for (size_t j = 0; j < len; j++)
+        {
+            words[k * (MAX_WORD + 1) + j] = (j < 13) ? 'a' + digits % 26 : 'a' + next_random(&state) % 26;
+            digits /= 26;
+        }
+        lens[k] = (unsigned char)len;
+    }
+
+    // Probabilidades acumuladas de 1/k^s, normalizadas
+    double sum = 0;
+    for (size_t k = 0; k < vocabulary; k++)
+    {
+        sum += 1.0 / pow((double)(k + 1), exponent);
+        cdf[k] = sum;
+    }
+    for (size_t k = 0; k < vocabulary; k++)
+        cdf[k] /= sum;
+
+    // Escreve palavras sorteadas até atingir o tamanho pedido, com alguma pontuação entre elas
+    size_t written = 0, in_line = 0;
+    while (written < size)
+    {
+        double u = (double)(next_random(&state) >> 11) / (double)(1ULL << 53);
+        size_t k = sample(cdf, vocabulary, u);
+        fwrite(&words[k * (MAX_WORD + 1)], 1, lens[k], out);
+        written += lens[k];
+
+        uint64_t r = next_random(&state) % 16;
+        const char *sep = (++in_line == WORDS_PER_LINE) ? "\n" : (r == 0) ? ", " : (r == 1) ? ". " : " ";
+        if (in_line == WORDS_PER_LINE)
+            in_line = 0;
+        fputs(sep, out);
+        written += strlen(sep);
+    }
+
+    bool ok = fclose(out) == 0;
+    if (!ok)
+        perror("Error writing corpus");
+    free(words);
+    free(lens);
+    free(cdf);
+    return ok ? 0 : -1;
+}
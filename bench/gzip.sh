@@ -0,0 +1,70 @@
+#!/bin/sh
+# Benchmark da leitura de arquivos gzip: conta as 10 palavras mais usadas de cada texto a partir do
+# arquivo sem compressão (mapeado e lido em blocos pela entrada padrão), do .gz lido diretamente
+# (descompressão em outra thread), do .gz descomprimido por zcat em um pipe e do .gz descomprimido
+# antes para o disco, e escreve a vazão em MB/s de texto descomprimido. Os rankings são comparados.
+#
+# Uso: sh bench/gzip.sh [tamanho...]   (ex.: 16M 256M; padrão: 16M 64M)
+# Os textos ficam em $BENCH_DATA (padrão: $TMPDIR/ranking_words_bench), como em bench/pipeline.sh.
+
+set -e
+
+MAIN=./main
+ZIPF=bench/zipf
+DATA=${BENCH_DATA:-${TMPDIR:-/tmp}/ranking_words_bench}
+
+[ $# -gt 0 ] || set -- 16M 64M
+
+mkdir -p "$DATA"
+
+# Tempo atual em milissegundos
+now_ms() {
+    echo $(($(date +%s%N) / 1000000))
+}
+
+# Executa o comando, guardando a saída em $DATA/out.<nome>, e escreve quantos milissegundos ele levou
+time_ms() {
+    name=$1
+    shift
+    start=$(now_ms)
+    "$@" >"$DATA/out.$name"
+    echo $(($(now_ms) - start))
+}
+
+# Vazão em MB/s para 'bytes' bytes em 'ms' milissegundos
+rate() {
+    awk -v b="$1" -v ms="$2" 'BEGIN { printf "%.0f", (ms > 0) ? b / 1e6 / (ms / 1e3) : 0 }'
+}
+
+run() {
+    file=$1
+    name=$2
+    gz="$DATA/$(basename "$file").gz"
+    [ -f "$gz" ] || gzip -c "$file" >"$gz"
+    bytes=$(wc -c <"$file")
+    compressed=$(wc -c <"$gz")
+
+    mapped=$(time_ms mapped "$MAIN" 10 "$file")
+    blocks=$(time_ms blocks sh -c "\"$MAIN\" 10 - <\"$file\"")
+    native=$(time_ms native "$MAIN" 10 "$gz")
+    piped=$(time_ms piped sh -c "zcat \"$gz\" | \"$MAIN\" 10 -")
+    disk=$(time_ms disk sh -c "zcat \"$gz\" >\"$DATA/unpacked.txt\" && \"$MAIN\" 10 \"$DATA/unpacked.txt\"")
+    rm -f "$DATA/unpacked.txt"
+
+    check=""
+    for out in blocks native piped disk; do
+        cmp -s "$DATA/out.mapped" "$DATA/out.$out" || check="  MISMATCH ($out)"
+    done
+    rm -f "$DATA"/out.*
+
+    printf "%-14s %11s bytes (gz %10s)   mapeado %5s MB/s   blocos %5s MB/s   .gz %5s MB/s   zcat| %5s MB/s   zcat>disco %5s MB/s%s\n" \
+        "$name" "$bytes" "$compressed" "$(rate "$bytes" "$mapped")" "$(rate "$bytes" "$blocks")" \
+        "$(rate "$bytes" "$native")" "$(rate "$bytes" "$piped")" "$(rate "$bytes" "$disk")" "$check"
+}
+
+run padre_amaro.txt "padre_amaro"
+for size in "$@"; do
+    file="$DATA/zipf-$size.txt"
+    [ -f "$file" ] || "$ZIPF" "$size" "$file"
+    run "$file" "zipf-$size"
+done
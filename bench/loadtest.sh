@@ -0,0 +1,57 @@
+#!/bin/sh
+# Teste de carga do servidor ("main serve"): inicia o servidor com o livro, executa clientes em
+# paralelo, cada um repetindo o mesmo pedido, e escreve a latência e a vazão somada de cada pedido.
+#
+# Uso: sh bench/loadtest.sh [clientes] [pedidos por cliente]   (padrão: 4 clientes, 20000 pedidos)
+
+set -e
+
+MAIN=./main
+CLIENT=./client
+BOOK=padre_amaro.txt
+CLIENTS=${1:-4}
+REPEAT=${2:-20000}
+DIR=$(mktemp -d "${TMPDIR:-/tmp}/ranking_words_loadtest.XXXXXX") # Socket e resultados dos clientes
+SOCKET=$DIR/server.sock
+
+# O servidor tem uma thread por cliente, para que nenhum cliente espere na fila
+"$MAIN" serve --socket "$SOCKET" --threads "$CLIENTS" "$BOOK" 2>/dev/null &
+SERVER=$!
+trap 'kill $SERVER 2>/dev/null; wait $SERVER; rm -rf "$DIR"' EXIT
+
+# Espera o servidor terminar de contar o livro
+tries=0
+until "$CLIENT" --socket "$SOCKET" LIST >/dev/null 2>&1; do
+    tries=$((tries + 1))
+    if [ "$tries" -gt 100 ]; then
+        echo "O servidor não iniciou" >&2
+        exit 1
+    fi
+    sleep 0.1
+done
+
+# Executa os clientes em paralelo e junta os resultados: latências do pior cliente e vazão somada
+run() {
+    name=$1
+    shift
+    i=0
+    pids=""
+    while [ "$i" -lt "$CLIENTS" ]; do
+        "$CLIENT" --socket "$SOCKET" --repeat "$REPEAT" "$@" >"$DIR/client.$i" &
+        pids="$pids $!"
+        i=$((i + 1))
+    done
+    # Espera só os clientes (o servidor também é um processo filho)
+    for pid in $pids; do
+        wait "$pid"
+    done
+    cat "$DIR"/client.* | awk -v name="$name" -v clients="$CLIENTS" '
+        { requests += $2; if ($4 > p50) p50 = $4; if ($6 > p99) p99 = $6; if ($8 > max) max = $8; rate += $10 }
+        END { printf "%-10s %2d clientes %9d pedidos   p50 %8.1f us   p99 %8.1f us   máx %9.1f us   %9.0f pedidos/s\n",
+                     name, clients, requests, p50, p99, max, rate }'
+    rm -f "$DIR"/client.*
+}
+
+run "TOP 10" TOP "$BOOK" 10
+run "TOP 1000" TOP "$BOOK" 1000
+run "COUNT" COUNT "$BOOK" Amaro
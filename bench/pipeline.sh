@@ -0,0 +1,84 @@
+#!/bin/sh
+# Benchmark do programa inteiro: conta as 10 palavras mais usadas do livro e de textos sintéticos
+# com distribuição de Zipf, com cada motor, e compara com o comando do README
+# (tr | sort | uniq -c | sort -rn).
+#
+# Uso: sh bench/pipeline.sh [tamanho...]   (ex.: 1M 16M 1G; padrão: 1M 16M 64M)
+# Os textos gerados ficam em $BENCH_DATA (padrão: $TMPDIR/ranking_words_bench) e são reaproveitados.
+
+set -e
+
+MAIN=./main
+ZIPF=bench/zipf
+DATA=${BENCH_DATA:-${TMPDIR:-/tmp}/ranking_words_bench}
+SORT_LIMIT=268435456 # O motor "sort" guarda todas as palavras: acima de 256 MiB ele não é medido
+THREADS=$(nproc 2>/dev/null || echo 4)
+
+# O sort do comando de referência compara bytes, como o programa
+LC_ALL=C
+export LC_ALL
+
+[ $# -gt 0 ] || set -- 1M 16M 64M
+
+mkdir -p "$DATA"
+
+# Tempo atual em milissegundos
+now_ms() {
+    echo $(($(date +%s%N) / 1000000))
+}
+
+# Executa o comando, descartando a saída, e escreve quantos milissegundos ele levou
+time_ms() {
+    start=$(now_ms)
+    "$@" >/dev/null
+    echo $(($(now_ms) - start))
+}
+
+# Comando de referência do README
+baseline() {
+    tr -cs '[:alpha:]À-ÿ' '[\n*]' <"$1" | sort | uniq -c | sort -rn | head -n 10
+}
+
+# Contagens das 10 primeiras posições, para comparar com a referência (os empates podem mudar a ordem)
+main_counts() {
+    "$MAIN" 10 "$1" | sed 's/.*", \([0-9]*\) aparições/\1/'
+}
+baseline_counts() {
+    baseline "$1" | awk '{print $1}'
+}
+
+run() {
+    file=$1
+    name=$2
+    bytes=$(wc -c <"$file")
+
+    hash=$(time_ms "$MAIN" 10 "$file")
+    threads=$(time_ms "$MAIN" --threads "$THREADS" 10 "$file")
+    if [ "$bytes" -le "$SORT_LIMIT" ]; then
+        sort_engine=$(time_ms "$MAIN" --engine=sort 10 "$file")
+    else
+        sort_engine="-"
+    fi
+    reference=$(time_ms baseline "$file")
+
+    # Os textos sintéticos só têm letras ASCII, então a referência deve dar as mesmas contagens
+    check=""
+    case $name in
+    zipf*)
+        if [ "$(main_counts "$file")" != "$(baseline_counts "$file")" ]; then
+            check="  MISMATCH"
+        fi
+        ;;
+    esac
+
+    speedup=$(awk -v a="$reference" -v b="$hash" 'BEGIN { printf "%.2f", (b > 0) ? a / b : 0 }')
+    printf "%-20s %12s bytes   hash %7s ms   %2s threads %7s ms   sort %7s ms   baseline %7s ms   speedup %6sx%s\n" \
+        "$name" "$bytes" "$hash" "$THREADS" "$threads" "$sort_engine" "$reference" "$speedup" "$check"
+}
+
+run padre_amaro.txt "padre_amaro"
+for size in "$@"; do
+    file="$DATA/zipf-$size.txt"
+    [ -f "$file" ] || "$ZIPF" "$size" "$file"
+    run "$file" "zipf-$size"
+done
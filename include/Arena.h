@@ -0,0 +1,41 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+/* Macro para o tamanho padrão de cada bloco da arena */
+#define ARENA_CHUNK_SIZE (64 * 1024)
+
+typedef struct Intarena arena;
+
+/*-------------------------------------------------------
+    Declarações das funções da arena de strings
+-------------------------------------------------------*/
+
+/* Cria uma arena de strings vazia */
+arena *arena_create(void);
+
+/*
+ * Copia 'len' bytes de 'str' para a arena, junto com seu tamanho e um '\0' no final.
+ * Retorna o "handle" da string: um ponteiro estável (os blocos nunca são movidos) que
+ * pode ser usado como string C até a arena ser liberada. Retorna NULL se faltar memória.
+ */
+const char *arena_store(arena *a, const char *str, size_t len);
+
+/*
+ * Reserva 'size' bytes na arena, alinhados para qualquer tipo. O bloco é estável e só é
+ * liberado junto com a arena. Retorna NULL se faltar memória.
+ */
+void *arena_alloc(arena *a, size_t size);
+
+/* Retorna o tamanho da string guardada na arena a partir do seu handle */
+size_t arena_len(const char *handle);
+
+/* Retorna a quantidade de bytes reservados pela arena */
+size_t arena_size(arena *a);
+
+/* Libera todos os blocos da arena (os handles deixam de ser válidos) */
+void arena_free(arena *a);
+
+#endif /* ARENA_H */
@@ -0,0 +1,51 @@
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <GenericDynvec.h>
+#include <Wordmap.h>
+
+/* Macro para a quantidade máxima de arquivos lidos que esperam por uma thread de contagem */
+#define CORPUS_QUEUE_SIZE 8
+
+typedef struct Intcorpus corpus;
+
+/* Resultado da contagem de um documento */
+typedef struct CorpusDocument
+{
+    const char *path; // Caminho do documento
+    bool ok;          // Indica se o documento foi lido e contado sem erros
+    int error;        // Valor de errno quando 'ok' é false
+    size_t words;     // Quantidade total de palavras
+    size_t unique;    // Quantidade de palavras distintas
+    dynvec *top;      // As 'n' palavras mais usadas (wordmap_entry), da mais usada para a menos usada
+} corpus_document;
+
+/*-------------------------------------------------------
+    Declarações das funções do corpus
+-------------------------------------------------------*/
+
+/*
+ * Conta as palavras dos 'count' documentos em 'paths' com um pipeline: 'readers' threads
+ * leem os arquivos inteiros para uma fila limitada a CORPUS_QUEUE_SIZE arquivos, enquanto
+ * 'workers' threads tiram os arquivos da fila e contam suas palavras, de forma que a leitura
+ * do disco e a contagem acontecem ao mesmo tempo.
+ * Guarda as 'n' palavras mais usadas de cada documento e junta as tabelas de todos em uma
+ * tabela global. Os caminhos não são copiados. Retorna NULL se faltar memória.
+ */
+corpus *corpus_count(const char **paths, size_t count, size_t n, int readers, int workers);
+
+/* Retorna a quantidade de documentos */
+size_t corpus_length(corpus *c);
+
+/* Retorna o resultado do documento 'i', na mesma ordem de 'paths' */
+corpus_document *corpus_get(corpus *c, size_t i);
+
+/* Retorna a tabela com as aparições de cada palavra somadas em todos os documentos */
+wordmap *corpus_total(corpus *c);
+
+/* Libera a memória do corpus e de todos os resultados */
+void corpus_free(corpus *c);
+
+#endif /* CORPUS_H */
@@ -0,0 +1,53 @@
+#ifndef EXTERNAL_H
+#define EXTERNAL_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+/* Macro para o tamanho do buffer de leitura e escrita de cada arquivo temporário */
+#define EXTERNAL_IO_BUFFER (64 * 1024)
+
+/* Macro para o menor orçamento de memória aceito (a tabela vazia já ocupa algumas dezenas de KiB) */
+#define EXTERNAL_MIN_BUDGET (256 * 1024)
+
+/* Macro para a quantidade máxima de arquivos temporários abertos ao mesmo tempo */
+#define EXTERNAL_MAX_RUNS 64
+
+/* Macro para a quantidade de arquivos temporários de um mesmo nível mesclados em um do nível seguinte */
+#define EXTERNAL_MERGE_FANIN 8
+
+typedef struct Intexternal external;
+
+/* Função chamada para cada palavra distinta ao final da contagem, com o total de aparições */
+typedef bool (*external_emit)(const char *word, size_t len, size_t times, void *ctx);
+
+/*-------------------------------------------------------
+    Declarações das funções da contagem em disco
+-------------------------------------------------------*/
+
+/*
+ * Cria um contador de palavras que usa no máximo aproximadamente 'budget' bytes de memória.
+ * Quando a tabela em memória passa do orçamento, ela é gravada ordenada por palavra em um
+ * arquivo temporário (em $TMPDIR ou /tmp) e esvaziada. Os arquivos são mesclados em níveis:
+ * EXTERNAL_MERGE_FANIN arquivos de um nível viram um só do nível seguinte, de forma que cada
+ * palavra é regravada O(log(arquivos)) vezes e no máximo EXTERNAL_MAX_RUNS ficam abertos.
+ */
+external *external_create(size_t budget);
+
+/* Registra uma aparição da palavra. Retorna false em caso de erro de memória ou de escrita */
+bool external_add(external *ex, const char *word, size_t len);
+
+/*
+ * Termina a contagem: mescla os arquivos temporários (k-way merge) somando as contagens
+ * e chama 'emit' uma vez para cada palavra distinta, com a contagem exata.
+ * Retorna false em caso de erro ou se 'emit' retornar false.
+ */
+bool external_finish(external *ex, external_emit emit, void *ctx);
+
+/* Retorna a quantidade de arquivos temporários existentes */
+size_t external_runs(external *ex);
+
+/* Libera a memória e apaga os arquivos temporários */
+void external_free(external *ex);
+
+#endif /* EXTERNAL_H */
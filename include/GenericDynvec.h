@@ -4,12 +4,45 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <Stats.h>
+#include <Arena.h>
+#include <Threadpool.h>
 
 /* Macro para capacidade inicial do vetor dinâmico */
 #define DYNVEC_INIT_CAPACITY 8
 
+/*
+ * Macro para a redução da capacidade: o vetor só reduz a capacidade à metade quando ocupa no
+ * máximo 1/DYNVEC_SHRINK_FACTOR dela. Como depois da redução ele ainda tem folga nos dois
+ * sentidos, inserções e remoções alternadas perto do limite não realocam a cada operação.
+ */
+#define DYNVEC_SHRINK_FACTOR 8
+
+/* Macro para o tamanho mínimo (em elementos) de cada bloco das funções paralelas */
+#define DYNVEC_PARALLEL_CHUNK 4096
+
+/* Macro que chama o comparador 'cmp', contando a comparação nas estatísticas (--stats) */
+#define DYNVEC_COMPARE(cmp, a, b) (STATS_INC(STATS_COMPARISONS), cmp(a, b))
+
 typedef struct Intdynvec dynvec;
 
+/*
+ * Alocador de memória de um vetor dinâmico. As funções recebem o contexto 'ctx' e os tamanhos
+ * em bytes, inclusive o tamanho atual do bloco ('old_size' e 'size'), para que alocadores sem
+ * cabeçalho possam redimensionar ou reaproveitar os blocos. 'resize' preserva o conteúdo (como
+ * o realloc) e, como 'alloc', retorna NULL se faltar memória.
+ */
+typedef struct DynvecAllocator
+{
+    void *(*alloc)(void *ctx, size_t size);
+    void *(*resize)(void *ctx, void *ptr, size_t old_size, size_t new_size);
+    void (*release)(void *ctx, void *ptr, size_t size);
+    void *ctx;
+} dynvec_allocator;
+
+/* Pool de blocos reaproveitáveis para vetores dinâmicos */
+typedef struct Intdynvec_pool dynvec_pool;
+
 /*
  * Estrutura auxiliar utilizada para armazenar os limites
  * das partições no quicksort 3-way.
@@ -20,13 +53,35 @@ typedef struct Limits Limits;
     Declarações das funções do vetor dinâmico
 -------------------------------------------------------*/
 
-/* Cria e inicializa um vetor dinâmico com o tamanho de elemento especificado */
+/* Cria e inicializa um vetor dinâmico com o tamanho de elemento especificado (alocador do sistema) */
 dynvec *dynvec_create(size_t elem_size);
 
+/*
+ * Cria um vetor dinâmico cuja memória (inclusive a da própria estrutura) vem de 'allocator',
+ * que não é copiado e deve continuar válido até o vetor ser liberado.
+ */
+dynvec *dynvec_create_with(size_t elem_size, const dynvec_allocator *allocator);
+
 /* Insere um novo elemento no final do vetor */
 bool dynvec_push(dynvec *vec, void *item);
 
-/* Remove e retorna uma cópia do último elemento do vetor */
+/* Insere no final do vetor os 'count' elementos consecutivos de 'items', com no máximo uma realocação */
+bool dynvec_push_n(dynvec *vec, const void *items, size_t count);
+
+/* Insere no final de 'dst' todos os elementos de 'src' (do mesmo tamanho; pode ser o próprio 'dst') */
+bool dynvec_extend(dynvec *dst, dynvec *src);
+
+/*
+ * Garante capacidade para pelo menos 'n' elementos. A capacidade reservada também é o limite
+ * inferior das reduções: remoções não devolvem essa memória, e o vetor pode ser esvaziado e
+ * preenchido de novo (dynvec_clear) sem realocar.
+ */
+bool dynvec_reserve(dynvec *vec, size_t n);
+
+/* Remove o último elemento, copiando-o para 'out' (se não for NULL). Não aloca memória */
+bool dynvec_pop_into(dynvec *vec, void *out);
+
+/* Remove e retorna uma cópia do último elemento do vetor (alocada com malloc; prefira dynvec_pop_into) */
 void *dynvec_pop(dynvec *vec);
 
 /* Retorna o elemento na posição 'i'. Retorna NULL se 'i' for inválido */
@@ -68,11 +123,11 @@ size_t dynvec_exists_index(dynvec *vec, bool (*predicate)(void *));
 /* Cria um novo vetor contendo somente os elementos que satisfazem o predicado */
 dynvec *dynvec_filter(dynvec *vec, bool (*predicate)(void *));
 
-/* Busca linear: retorna o índice do elemento que corresponde à chave; se não encontrado, retorna -1 */
-int dynvec_lsearch(dynvec *vec, void *key, int (*cmp)(const void *, const void *));
+/* Busca linear: retorna o índice do elemento que corresponde à chave; se não encontrado, retorna (size_t)-1 */
+size_t dynvec_lsearch(dynvec *vec, void *key, int (*cmp)(const void *, const void *));
 
-/* Busca binária (para vetor ordenado): retorna o índice do elemento que corresponde à chave; se não encontrado, retorna -1 */
-int dynvec_bsearch(dynvec *vec, void *key, int (*cmp)(const void *, const void *));
+/* Busca binária (para vetor ordenado): retorna o índice do elemento que corresponde à chave; se não encontrado, retorna (size_t)-1 */
+size_t dynvec_bsearch(dynvec *vec, void *key, int (*cmp)(const void *, const void *));
 
 /* Retorna a capacidade atual do vetor */
 size_t dynvec_capacity(dynvec *vec);
@@ -86,9 +141,38 @@ size_t dynvec_elem_size(dynvec *vec);
 /* Reinicializa o vetor, liberando os elementos e alocando novamente com capacidade inicial */
 bool dynvec_empty(dynvec *vec);
 
+/* Remove todos os elementos, mantendo a capacidade atual (não aloca nem libera memória) */
+void dynvec_clear(dynvec *vec);
+
 /* Libera a memória alocada para o vetor dinâmico */
 void dynvec_free(dynvec *vec);
 
+/*-------------------------------------------------------
+    Declarações dos alocadores
+-------------------------------------------------------*/
+
+/* Alocador do sistema (malloc, realloc e free), utilizado por dynvec_create */
+extern const dynvec_allocator dynvec_system_allocator;
+
+/*
+ * Cria um pool de blocos: os blocos liberados pelos vetores são guardados em listas por classe
+ * de tamanho (potências de 2) e reaproveitados, de forma que vetores criados e liberados em um
+ * laço deixam de chamar o malloc depois das primeiras iterações. Não é thread-safe.
+ */
+dynvec_pool *dynvec_pool_create(void);
+
+/* Retorna o alocador do pool, válido até o pool ser liberado */
+const dynvec_allocator *dynvec_pool_allocator(dynvec_pool *pool);
+
+/* Libera o pool e os blocos guardados nele (os vetores do pool devem ser liberados antes) */
+void dynvec_pool_free(dynvec_pool *pool);
+
+/*
+ * Retorna um alocador que reserva os blocos na arena 'a'. Liberar um bloco não faz nada: a memória
+ * só é devolvida junto com a arena, que deve continuar válida enquanto os vetores forem usados.
+ */
+dynvec_allocator dynvec_arena_allocator(arena *a);
+
 /*-------------------------------------------------------
     Declarações das funções de ordenação
 -------------------------------------------------------*/
@@ -108,4 +192,428 @@ void quicksort_dynvec_three_way(dynvec *vec, int (*cmp)(const void *, const void
  */
 void mergesort_dynvec(dynvec *vec, void *temp_data, int (*cmp)(const void *, const void *), size_t left, size_t right);
 
+/*
+ * Ordenação utilizando Mergesort paralelo, com o mesmo contrato de mergesort_dynvec.
+ * - 'threads' é o número máximo de threads utilizadas (incluindo a atual).
+ * As duas metades são ordenadas em paralelo e os merges dos níveis mais altos também são
+ * divididos entre as threads. Intervalos pequenos usam a versão sequencial. A ordenação
+ * continua estável e o resultado é idêntico ao de mergesort_dynvec.
+ */
+void mergesort_dynvec_parallel(dynvec *vec, void *temp_data, int (*cmp)(const void *, const void *), size_t left, size_t right, int threads);
+
+/*
+ * Ordenação de strings com o multikey quicksort (Bentley–Sedgewick): particiona pelo
+ * caractere na profundidade 'd' e só avança para o próximo caractere na partição dos
+ * iguais, sem comparar de novo os prefixos comuns. Partições pequenas usam insertion sort.
+ * - 'strings' é um vetor de 'n' ponteiros para strings terminadas em '\0'.
+ */
+void multikey_quicksort(const char **strings, size_t n);
+
+/* Ordena com o multikey quicksort um vetor dinâmico cujos elementos são do tipo 'char *' */
+void dynvec_sort_strings(dynvec *vec);
+
+/*
+ * Seleção dos 'k' maiores elementos utilizando um heap limitado a 'k' elementos.
+ * - 'cmp' é a função de comparação.
+ * Retorna um novo vetor com os 'k' maiores elementos, do maior para o menor,
+ * usando O(k) de memória extra; retorna NULL caso não seja possível alocar memória.
+ */
+dynvec *dynvec_top_k(dynvec *vec, size_t k, int (*cmp)(const void *, const void *));
+
+/*
+ * Como dynvec_top_k, mas escreve os 'k' maiores elementos em 'out' (outro vetor, com o mesmo
+ * tamanho de elemento), substituindo o seu conteúdo. Reaproveitando 'out', seleções repetidas
+ * não alocam memória. Retorna false se faltar memória.
+ */
+bool dynvec_top_k_into(dynvec *vec, size_t k, int (*cmp)(const void *, const void *), dynvec *out);
+
+/*-------------------------------------------------------
+    Declarações das funções paralelas
+-------------------------------------------------------*/
+
+/*
+ * As versões paralelas dividem o vetor em blocos de pelo menos DYNVEC_PARALLEL_CHUNK elementos,
+ * executados pelas threads do 'pool' (threadpool_create), que pode ser compartilhado por várias
+ * chamadas. As funções recebidas são chamadas de várias threads ao mesmo tempo, para elementos
+ * diferentes. Vetores menores que um bloco (ou 'pool' NULL) são processados na thread atual.
+ */
+
+/* Aplica uma função de processamento em cada elemento do vetor, em paralelo */
+void dynvec_map_parallel(dynvec *vec, void (*processo)(void *), threadpool *pool);
+
+/*
+ * Fold em paralelo com combinação associativa. Cada bloco acumula os seus elementos com 'func'
+ * em um acumulador parcial de 'acc_size' bytes, que começa como cópia de 'identity'; os parciais
+ * são então combinados em 'acc', na ordem dos blocos, com combine(acc, parcial). O resultado é o
+ * mesmo de dynvec_fold_left quando 'combine' é associativa e 'identity' é o seu elemento neutro
+ * (ex.: soma e 0). Retorna false se faltar memória ('acc' não é alterado).
+ */
+bool dynvec_fold_parallel(dynvec *vec, void *acc, size_t acc_size, const void *identity,
+                          void (*func)(void *acc, void *elem), void (*combine)(void *acc, const void *partial),
+                          threadpool *pool);
+
+/*
+ * Cria um novo vetor com os elementos que satisfazem o predicado, na mesma ordem do vetor
+ * original. Cada bloco marca e conta os seus elementos; a soma de prefixos das contagens dá
+ * a posição de cada bloco no resultado, e os blocos copiam os seus elementos em paralelo.
+ * O predicado é avaliado uma vez por elemento. Retorna NULL se faltar memória.
+ */
+dynvec *dynvec_filter_parallel(dynvec *vec, bool (*predicate)(void *), threadpool *pool);
+
+/* Verifica em paralelo se todos os elementos satisfazem o predicado; as threads param quando uma encontra um que não satisfaz */
+bool dynvec_forall_parallel(dynvec *vec, bool (*predicate)(void *), threadpool *pool);
+
+/* Verifica em paralelo se algum elemento satisfaz o predicado; as threads param quando uma o encontra */
+bool dynvec_exists_parallel(dynvec *vec, bool (*predicate)(void *), threadpool *pool);
+
+/*-------------------------------------------------------
+    Vetor dinâmico especializado por tipo
+-------------------------------------------------------*/
+
+/*
+ * Gera um vetor dinâmico para o tipo concreto 'T', chamado 'name'. As funções geradas
+ * (name_create, name_push, name_get, ...) têm a mesma semântica das funções genéricas,
+ * mas trabalham diretamente com 'T', sem 'elem_size' nem memcpy, e podem ser inlinadas.
+ *
+ * Exemplo:
+ *     DYNVEC_DEFINE(word, word_vec)
+ *     word_vec *vec = word_vec_create();
+ *     word_vec_push(vec, w);
+ */
+#define DYNVEC_DEFINE(T, name)                                                             \
+    typedef struct name                                                                    \
+    {                                                                                      \
+        T *data;         /* Elementos */                                                   \
+        size_t capacity; /* Capacidade atual do vetor */                                   \
+        size_t length;   /* Número de elementos armazenados */                             \
+    } name;                                                                                \
+                                                                                           \
+    /* Cria e inicializa um vetor vazio */                                                 \
+    static inline name *name##_create(void)                                                \
+    {                                                                                      \
+        name *vec = (name *)malloc(sizeof(name));                                          \
+        if (!vec)                                                                          \
+            return NULL;                                                                   \
+        vec->capacity = DYNVEC_INIT_CAPACITY;                                              \
+        vec->length = 0;                                                                   \
+        vec->data = (T *)malloc(sizeof(T) * vec->capacity);                                \
+        if (!vec->data)                                                                    \
+        {                                                                                  \
+            free(vec);                                                                     \
+            return NULL;                                                                   \
+        }                                                                                  \
+        STATS_ADD(STATS_ALLOCATIONS, 2);                                                   \
+        return vec;                                                                        \
+    }                                                                                      \
+                                                                                           \
+    /* Insere um novo elemento no final do vetor */                                        \
+    static inline bool name##_push(name *vec, T item)                                      \
+    {                                                                                      \
+        if (vec->length == vec->capacity)                                                  \
+        {                                                                                  \
+            T *temp = (T *)realloc(vec->data, sizeof(T) * vec->capacity * 2);              \
+            if (!temp)                                                                     \
+                return false;                                                              \
+            vec->data = temp;                                                              \
+            vec->capacity *= 2;                                                            \
+            STATS_INC(STATS_RESIZES);                                                      \
+            STATS_INC(STATS_ALLOCATIONS);                                                  \
+        }                                                                                  \
+        vec->data[vec->length++] = item;                                                   \
+        return true;                                                                       \
+    }                                                                                      \
+                                                                                           \
+    /* Remove o último elemento, guardando-o em 'out' (se não for NULL) */                 \
+    static inline bool name##_pop(name *vec, T *out)                                       \
+    {                                                                                      \
+        if (vec->length == 0)                                                              \
+            return false;                                                                  \
+        vec->length--;                                                                     \
+        if (out)                                                                           \
+            *out = vec->data[vec->length];                                                 \
+        return true;                                                                       \
+    }                                                                                      \
+                                                                                           \
+    /* Retorna o elemento na posição 'i'. Retorna NULL se 'i' for inválido */              \
+    static inline T *name##_get(name *vec, size_t i)                                       \
+    {                                                                                      \
+        return (i < vec->length) ? &vec->data[i] : NULL;                                   \
+    }                                                                                      \
+                                                                                           \
+    /* Retorna o número de elementos armazenados */                                        \
+    static inline size_t name##_length(const name *vec)                                    \
+    {                                                                                      \
+        return vec->length;                                                                \
+    }                                                                                      \
+                                                                                           \
+    /* Libera a memória alocada para o vetor */                                            \
+    static inline void name##_free(name *vec)                                              \
+    {                                                                                      \
+        if (vec)                                                                           \
+        {                                                                                  \
+            free(vec->data);                                                               \
+            free(vec);                                                                     \
+        }                                                                                  \
+    }
+
+/* Tamanho das partições que o sort especializado ordena com insertion sort */
+#define DYNVEC_INSERTION_CUTOFF 16
+
+/*
+ * Gera as funções de ordenação do vetor 'name' (criado com DYNVEC_DEFINE) para o
+ * comparador 'cmp', que deve ter a assinatura int cmp(const T *, const T *).
+ * Como o comparador é conhecido em tempo de compilação, ele é inlinado nas funções:
+ * - name_sort: introsort com pivô mediana de 3 e insertion sort nas partições pequenas.
+ *   Como em introsort_three_way, a recursão tem limite 2*log2(n) e, ao atingi-lo,
+ *   a partição é ordenada com heapsort, mantendo O(n log n) em entradas adversárias;
+ * - name_top_k: cria um novo vetor com os 'k' maiores elementos, do maior para o menor.
+ */
+#define DYNVEC_DEFINE_SORT(T, name, cmp)                                                   \
+    /* Ordena a[0..n) por inserção */                                                      \
+    static inline void name##_insertion_sort(T *a, size_t n)                               \
+    {                                                                                      \
+        for (size_t i = 1; i < n; i++)                                                     \
+        {                                                                                  \
+            T item = a[i];                                                                 \
+            size_t j = i;                                                                  \
+            for (; j > 0 && DYNVEC_COMPARE(cmp, &item, &a[j - 1]) < 0; j--)                \
+                a[j] = a[j - 1];                                                           \
+            a[j] = item;                                                                   \
+        }                                                                                  \
+    }                                                                                      \
+                                                                                           \
+    /* Desce o elemento 'i' no heap de máximo a[0..n) */                                   \
+    static inline void name##_sift_down_max(T *a, size_t i, size_t n)                      \
+    {                                                                                      \
+        T item = a[i];                                                                     \
+        for (size_t child; (child = 2 * i + 1) < n; i = child)                             \
+        {                                                                                  \
+            if (child + 1 < n && DYNVEC_COMPARE(cmp, &a[child + 1], &a[child]) > 0)        \
+                child++;                                                                   \
+            if (DYNVEC_COMPARE(cmp, &a[child], &item) <= 0)                                \
+                break;                                                                     \
+            a[i] = a[child];                                                               \
+        }                                                                                  \
+        a[i] = item;                                                                       \
+    }                                                                                      \
+                                                                                           \
+    /* Heapsort de a[0..n): fallback do quicksort quando a recursão fica profunda demais */ \
+    static inline void name##_heapsort(T *a, size_t n)                                     \
+    {                                                                                      \
+        for (size_t i = n / 2; i > 0; i--)                                                 \
+            name##_sift_down_max(a, i - 1, n);                                             \
+        for (size_t end = n; end > 1; end--)                                               \
+        {                                                                                  \
+            T tmp = a[0];                                                                  \
+            a[0] = a[end - 1];                                                             \
+            a[end - 1] = tmp;                                                              \
+            STATS_INC(STATS_SWAPS);                                                        \
+            name##_sift_down_max(a, 0, end - 1);                                           \
+        }                                                                                  \
+    }                                                                                      \
+                                                                                           \
+    /* Introsort de a[0..n) com 'depth' níveis restantes: recursão na menor partição, laço na maior */ \
+    static inline void name##_introsort(T *a, size_t n, size_t depth)                      \
+    {                                                                                      \
+        while (n > DYNVEC_INSERTION_CUTOFF)                                                \
+        {                                                                                  \
+            if (depth == 0)                                                                \
+            {                                                                              \
+                name##_heapsort(a, n);                                                     \
+                return;                                                                    \
+            }                                                                              \
+            depth--;                                                                       \
+                                                                                           \
+            /* Mediana de 3: deixa a[0] <= a[mid] <= a[n - 1] */                           \
+            size_t mid = n / 2;                                                            \
+            T tmp;                                                                         \
+            if (DYNVEC_COMPARE(cmp, &a[mid], &a[0]) < 0)                                   \
+                tmp = a[mid], a[mid] = a[0], a[0] = tmp;                                   \
+            if (DYNVEC_COMPARE(cmp, &a[n - 1], &a[mid]) < 0)                               \
+            {                                                                              \
+                tmp = a[n - 1], a[n - 1] = a[mid], a[mid] = tmp;                           \
+                if (DYNVEC_COMPARE(cmp, &a[mid], &a[0]) < 0)                               \
+                    tmp = a[mid], a[mid] = a[0], a[0] = tmp;                               \
+            }                                                                              \
+            T pivot = a[mid];                                                              \
+                                                                                           \
+            /* Particionamento de Hoare */                                                 \
+            size_t i = 0, j = n - 1;                                                       \
+            for (;;)                                                                       \
+            {                                                                              \
+                while (DYNVEC_COMPARE(cmp, &a[i], &pivot) < 0)                             \
+                    i++;                                                                   \
+                while (DYNVEC_COMPARE(cmp, &pivot, &a[j]) < 0)                             \
+                    j--;                                                                   \
+                if (i >= j)                                                                \
+                    break;                                                                 \
+                tmp = a[i], a[i] = a[j], a[j] = tmp;                                       \
+                STATS_INC(STATS_SWAPS);                                                    \
+                i++;                                                                       \
+                j--;                                                                       \
+            }                                                                              \
+                                                                                           \
+            /* a[0..j] <= pivô <= a[j+1..n) */                                             \
+            size_t left = j + 1;                                                           \
+            if (left < n - left)                                                           \
+            {                                                                              \
+                name##_introsort(a, left, depth);                                          \
+                a += left;                                                                 \
+                n -= left;                                                                 \
+            }                                                                              \
+            else                                                                           \
+            {                                                                              \
+                name##_introsort(a + left, n - left, depth);                               \
+                n = left;                                                                  \
+            }                                                                              \
+        }                                                                                  \
+        name##_insertion_sort(a, n);                                                       \
+    }                                                                                      \
+                                                                                           \
+    /* Ordena a[0..n) */                                                                   \
+    static inline void name##_sort_range(T *a, size_t n)                                   \
+    {                                                                                      \
+        size_t depth = 0;                                                                  \
+        for (size_t m = n; m > 1; m >>= 1)                                                 \
+            depth += 2;                                                                    \
+        name##_introsort(a, n, depth);                                                     \
+    }                                                                                      \
+                                                                                           \
+    /* Ordena o vetor inteiro */                                                           \
+    static inline void name##_sort(name *vec)                                              \
+    {                                                                                      \
+        name##_sort_range(vec->data, vec->length);                                         \
+    }                                                                                      \
+                                                                                           \
+    /* Desce o elemento 'i' no heap de mínimo a[0..n) */                                   \
+    static inline void name##_sift_down(T *a, size_t i, size_t n)                          \
+    {                                                                                      \
+        T item = a[i];                                                                     \
+        for (size_t child; (child = 2 * i + 1) < n; i = child)                             \
+        {                                                                                  \
+            if (child + 1 < n && DYNVEC_COMPARE(cmp, &a[child + 1], &a[child]) < 0)        \
+                child++;                                                                   \
+            if (DYNVEC_COMPARE(cmp, &a[child], &item) >= 0)                                \
+                break;                                                                     \
+            a[i] = a[child];                                                               \
+        }                                                                                  \
+        a[i] = item;                                                                       \
+    }                                                                                      \
+                                                                                           \
+    /* Cria um novo vetor com os 'k' maiores elementos, do maior para o menor */           \
+    static inline name *name##_top_k(name *vec, size_t k)                                  \
+    {                                                                                      \
+        name *heap = name##_create();                                                      \
+        if (!heap)                                                                         \
+            return NULL;                                                                   \
+        for (size_t i = 0; i < vec->length && k > 0; i++)                                  \
+        {                                                                                  \
+            if (heap->length < k)                                                          \
+            {                                                                              \
+                if (!name##_push(heap, vec->data[i]))                                      \
+                {                                                                          \
+                    name##_free(heap);                                                     \
+                    return NULL;                                                           \
+                }                                                                          \
+                /* Sobe o novo elemento */                                                 \
+                T *h = heap->data;                                                         \
+                T item = h[heap->length - 1];                                              \
+                size_t j = heap->length - 1;                                               \
+                for (; j > 0 && DYNVEC_COMPARE(cmp, &item, &h[(j - 1) / 2]) < 0; j = (j - 1) / 2) \
+                    h[j] = h[(j - 1) / 2];                                                 \
+                h[j] = item;                                                               \
+            }                                                                              \
+            else if (DYNVEC_COMPARE(cmp, &vec->data[i], &heap->data[0]) > 0)               \
+            {                                                                              \
+                heap->data[0] = vec->data[i];                                              \
+                name##_sift_down(heap->data, 0, heap->length);                             \
+            }                                                                              \
+        }                                                                                  \
+        /* Cada menor elemento vai para o final: o vetor fica do maior para o menor */     \
+        for (size_t end = heap->length; end > 1; end--)                                    \
+        {                                                                                  \
+            T tmp = heap->data[0];                                                         \
+            heap->data[0] = heap->data[end - 1];                                           \
+            heap->data[end - 1] = tmp;                                                     \
+            name##_sift_down(heap->data, 0, end - 1);                                      \
+        }                                                                                  \
+        return heap;                                                                       \
+    }
+
+/* Tamanho das partições que o multikey quicksort especializado ordena com insertion sort */
+#define DYNVEC_MULTIKEY_CUTOFF 12
+
+/*
+ * Gera o multikey quicksort de elementos do tipo T pela string que 'key' retorna para
+ * cada elemento, com a assinatura const char *key(const T *). Os prefixos comuns não são
+ * comparados de novo e os elementos são movidos inteiros: multikey_quicksort usa a própria
+ * string como elemento, e pares (palavra, valor) são ordenados sem buscar o valor depois.
+ * - name_sort_strings: ordena a[0..n).
+ */
+#define DYNVEC_DEFINE_STRING_SORT(T, name, key)                                            \
+    /* Ordena por inserção a[0..n), cujas strings têm os primeiros 'd' caracteres iguais */ \
+    static inline void name##_strings_insertion_sort(T *a, size_t n, size_t d)             \
+    {                                                                                      \
+        for (size_t i = 1; i < n; i++)                                                     \
+        {                                                                                  \
+            T item = a[i];                                                                 \
+            size_t j = i;                                                                  \
+            for (; j > 0 && (STATS_INC(STATS_COMPARISONS), strcmp(key(&a[j - 1]) + d, key(&item) + d) > 0); j--) \
+                a[j] = a[j - 1];                                                           \
+            a[j] = item;                                                                   \
+        }                                                                                  \
+    }                                                                                      \
+                                                                                           \
+    /* Multikey quicksort de a[0..n), cujas strings têm os primeiros 'd' caracteres iguais */ \
+    static inline void name##_multikey(T *a, size_t n, size_t d)                           \
+    {                                                                                      \
+        while (n > DYNVEC_MULTIKEY_CUTOFF)                                                 \
+        {                                                                                  \
+            /* Pivô: mediana dos caracteres do primeiro, do meio e do último elemento */   \
+            int x = (unsigned char)key(&a[0])[d], y = (unsigned char)key(&a[n / 2])[d];    \
+            int z = (unsigned char)key(&a[n - 1])[d];                                      \
+            int pivot = (x < y) ? ((y < z) ? y : (x < z) ? z : x) : ((x < z) ? x : (y < z) ? z : y); \
+                                                                                           \
+            /* Particionamento 3-way: [0, lt) < pivô, [lt, gt) = pivô, [gt, n) > pivô */   \
+            size_t lt = 0, i = 0, gt = n;                                                  \
+            T tmp;                                                                         \
+            while (i < gt)                                                                 \
+            {                                                                              \
+                int c = (unsigned char)key(&a[i])[d];                                      \
+                if (c < pivot)                                                             \
+                {                                                                          \
+                    tmp = a[lt], a[lt] = a[i], a[i] = tmp;                                 \
+                    lt++;                                                                  \
+                    i++;                                                                   \
+                }                                                                          \
+                else if (c > pivot)                                                        \
+                {                                                                          \
+                    gt--;                                                                  \
+                    tmp = a[gt], a[gt] = a[i], a[i] = tmp;                                 \
+                }                                                                          \
+                else                                                                       \
+                    i++;                                                                   \
+            }                                                                              \
+            STATS_ADD(STATS_COMPARISONS, n);                                               \
+            STATS_ADD(STATS_SWAPS, lt + (n - gt));                                         \
+                                                                                           \
+            name##_multikey(a, lt, d);                                                     \
+            name##_multikey(a + gt, n - gt, d);                                            \
+                                                                                           \
+            /* Strings iguais até o fim (pivô '\0') já estão ordenadas */                  \
+            if (pivot == 0)                                                                \
+                return;                                                                    \
+            a += lt;                                                                       \
+            n = gt - lt;                                                                   \
+            d++;                                                                           \
+        }                                                                                  \
+        name##_strings_insertion_sort(a, n, d);                                            \
+    }                                                                                      \
+                                                                                           \
+    /* Ordena a[0..n) pelas strings */                                                     \
+    static inline void name##_sort_strings(T *a, size_t n)                                 \
+    {                                                                                      \
+        name##_multikey(a, n, 0);                                                          \
+    }
+
 #endif /* DYNVEC_H */
\ No newline at end of file
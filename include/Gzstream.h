@@ -0,0 +1,46 @@
+#ifndef GZSTREAM_H
+#define GZSTREAM_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+/* Macro para o tamanho de cada um dos dois blocos de bytes descomprimidos */
+#define GZSTREAM_BLOCK_SIZE (256 * 1024)
+
+/* Macro para o tamanho dos pedaços do arquivo comprimido lidos por vez */
+#define GZSTREAM_INPUT_SIZE (64 * 1024)
+
+typedef struct Intgzstream gzstream;
+
+/*-------------------------------------------------------
+    Declarações das funções da leitura de arquivos gzip
+-------------------------------------------------------*/
+
+/*
+ * Verifica se o arquivo aberto em 'fd' começa com a assinatura do gzip (1f 8b). Lê com pread,
+ * sem mover a posição do descritor; retorna false se ele não permitir (pipes, terminais...).
+ */
+bool gzstream_detect(int fd);
+
+/*
+ * Começa a descomprimir o arquivo gzip aberto em 'fd' (que não é fechado pelo gzstream) em
+ * uma thread própria. A thread descomprime em dois blocos alternados: enquanto um bloco é
+ * consumido por gzstream_read, o outro já é preenchido. Membros concatenados (cat a.gz b.gz)
+ * são lidos em sequência. Os 'prefix_size' bytes de 'prefix' (no máximo GZSTREAM_INPUT_SIZE) são
+ * o começo do arquivo, já lido de 'fd' por quem chama: assim a assinatura pode ser verificada
+ * em pipes, onde não é possível voltar. Retorna NULL se faltar memória ou não for possível criar a thread.
+ */
+gzstream *gzstream_open(int fd, const void *prefix, size_t prefix_size);
+
+/*
+ * Copia até 'size' bytes descomprimidos para 'buf', esperando a thread quando nenhum bloco
+ * está pronto. Como o read: retorna a quantidade copiada, 0 no fim do arquivo e -1 em caso de
+ * erro (errno é EIO para dados corrompidos ou truncados).
+ */
+ssize_t gzstream_read(gzstream *gz, void *buf, size_t size);
+
+/* Interrompe a descompressão (se ainda não terminou) e libera a memória */
+void gzstream_close(gzstream *gz);
+
+#endif /* GZSTREAM_H */
@@ -0,0 +1,66 @@
+#ifndef NGRAM_H
+#define NGRAM_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <GenericDynvec.h>
+#include <Wordmap.h>
+
+/* Macro para o maior número de palavras de uma sequência */
+#define NGRAM_MAX_K 16
+
+typedef struct Intngrammap ngrammap;
+
+/*
+ * Entrada da tabela de sequências: a chave são os handles das K palavras (guardados uma
+ * única vez na arena da tabela), e não uma cópia do texto da sequência.
+ */
+typedef struct NgramEntry
+{
+    const char *key; // Handle, na arena, com os K handles das palavras (const char *) em sequência
+    size_t times;    // Quantidade de aparições
+    uint64_t hash;   // Hash da sequência (evita recalcular no redimensionamento)
+} ngram_entry;
+
+/*-------------------------------------------------------
+    Declarações das funções da tabela de sequências
+-------------------------------------------------------*/
+
+/*
+ * Cria uma tabela que conta as sequências de 'k' palavras consecutivas (1 <= k <= NGRAM_MAX_K).
+ * Retorna NULL se 'k' for inválido ou faltar memória.
+ */
+ngrammap *ngrammap_create(size_t k);
+
+/*
+ * Recebe a próxima palavra do texto. A palavra é guardada uma única vez no vocabulário da
+ * tabela, e seu handle entra em um buffer circular com as últimas K palavras; a partir da
+ * K-ésima palavra, cada chamada conta a sequência que termina nela. O hash da sequência é
+ * atualizado em O(1) (hash deslizante), sem montar o texto da sequência.
+ * Retorna false se faltar memória.
+ */
+bool ngrammap_add(ngrammap *nm, const char *word, size_t len);
+
+/* Retorna o número de sequências distintas */
+size_t ngrammap_length(ngrammap *nm);
+
+/* Retorna a tabela com o vocabulário (cada palavra lida, com suas aparições) */
+wordmap *ngrammap_words(ngrammap *nm);
+
+/*
+ * Retorna um novo vetor com as 'n' sequências mais frequentes (ngram_entry), da mais frequente
+ * para a menos frequente, desempatando pelas palavras. Retorna NULL se faltar memória.
+ */
+dynvec *ngrammap_top(ngrammap *nm, size_t n);
+
+/* Retorna a quantidade de palavras de uma sequência */
+size_t ngram_length(const ngram_entry *entry);
+
+/* Retorna a palavra 'j' (a partir de 0) da sequência */
+const char *ngram_word(const ngram_entry *entry, size_t j);
+
+/* Libera a memória da tabela, de suas sequências e do vocabulário */
+void ngrammap_free(ngrammap *nm);
+
+#endif /* NGRAM_H */
@@ -0,0 +1,42 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+/* Macro para o caminho padrão do socket do servidor */
+#define SERVER_DEFAULT_SOCKET "/tmp/ranking_words.sock"
+
+/* Macro para o tamanho máximo de uma linha do protocolo (pedido), com o '\n' */
+#define SERVER_LINE_MAX 4096
+
+/* Macro para a quantidade máxima de conexões aceitas que esperam por uma thread */
+#define SERVER_QUEUE_SIZE 64
+
+/*-------------------------------------------------------
+    Declarações das funções do servidor
+-------------------------------------------------------*/
+
+/*
+ * Conta as palavras dos 'count' livros em 'paths' uma única vez e atende pedidos em um socket
+ * Unix em 'socket_path' até receber SIGINT ou SIGTERM. Cada livro fica em memória com a sua
+ * tabela e o ranking completo, identificado pelo nome do arquivo (sem os diretórios).
+ *
+ * O protocolo é de linhas: cada pedido é uma linha, e cada resposta é "OK <k>" seguida de
+ * exatamente k linhas, ou uma única linha "ERR <mensagem>".
+ *   TOP <livro> <n>          as 'n' palavras mais usadas, uma por linha: "<palavra> <aparições>"
+ *   COUNT <livro> <palavra>  uma linha "<palavra> <aparições>"
+ *   RELOAD <livro>           conta o livro de novo; uma linha "<livro> <palavras> <distintas>"
+ *   LIST                     uma linha "<livro> <palavras> <distintas>" por livro
+ *   QUIT                     encerra a conexão
+ *
+ * A thread principal aceita as conexões e as coloca em uma fila limitada a SERVER_QUEUE_SIZE;
+ * 'workers' threads tiram as conexões da fila e atendem cada uma até o cliente desconectar.
+ * As consultas de um livro rodam em paralelo; RELOAD conta o livro fora da trava e só troca
+ * a tabela e o ranking, sem bloquear as consultas durante a contagem.
+ * Com 'fold', as palavras de COUNT passam pela normalização (tokenizer_set_fold), como as dos livros.
+ * Retorna false em caso de erro (errno indica a causa).
+ */
+bool server_run(const char *socket_path, const char **paths, size_t count, int workers, bool fold);
+
+#endif /* SERVER_H */
@@ -0,0 +1,54 @@
+#ifndef SPACESAVING_H
+#define SPACESAVING_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <GenericDynvec.h>
+
+/* Macro para a quantidade de linhas do sketch Count-Min */
+#define COUNTMIN_DEPTH 4
+
+typedef struct Intspacesaving spacesaving;
+
+/*
+ * Palavra monitorada e sua estimativa: a quantidade real de aparições está
+ * entre 'count - error' e 'count'.
+ */
+typedef struct SpaceSavingItem
+{
+    const char *word; // Palavra (válida até a próxima atualização da estrutura)
+    size_t count;     // Estimativa da quantidade de aparições (nunca menor que a real)
+    size_t error;     // Erro máximo da estimativa
+} spacesaving_item;
+
+/*-------------------------------------------------------
+    Declarações das funções do Space-Saving
+-------------------------------------------------------*/
+
+/*
+ * Cria uma estrutura Space-Saving que usa aproximadamente 'budget' bytes, independente
+ * do tamanho da entrada. Com 'count_min', metade do orçamento vai para um sketch
+ * Count-Min que estima a contagem das palavras que entram no lugar de outras,
+ * deixando as estimativas (e os erros) menores.
+ */
+spacesaving *spacesaving_create(size_t budget, bool count_min);
+
+/* Registra uma aparição da palavra. Retorna false caso não seja possível alocar memória */
+bool spacesaving_add(spacesaving *ss, const char *word, size_t len);
+
+/* Retorna a quantidade de palavras que a estrutura consegue monitorar */
+size_t spacesaving_capacity(spacesaving *ss);
+
+/* Retorna a quantidade total de palavras registradas */
+size_t spacesaving_total(spacesaving *ss);
+
+/*
+ * Retorna um novo vetor (de spacesaving_item) com as 'n' palavras de maior estimativa,
+ * da maior para a menor. Pode ser chamada a qualquer momento da leitura.
+ */
+dynvec *spacesaving_top(spacesaving *ss, size_t n);
+
+/* Libera a memória alocada para a estrutura */
+void spacesaving_free(spacesaving *ss);
+
+#endif /* SPACESAVING_H */
@@ -0,0 +1,86 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Estatísticas de execução (--stats): um cronômetro por fase e contadores de eventos.
+ * Com STATS_ENABLED 0 (make STATS=0), as macros abaixo não geram nenhum código.
+ */
+#ifndef STATS_ENABLED
+#define STATS_ENABLED 1
+#endif
+
+/* Contadores de eventos */
+typedef enum StatsCounter
+{
+    STATS_TOKENS,       // Palavras lidas pelo tokenizador
+    STATS_UNIQUE_WORDS, // Palavras distintas
+    STATS_BYTES_READ,   // Bytes lidos (ou mapeados) dos arquivos
+    STATS_COMPARISONS,  // Comparações feitas pelas ordenações, seleções e buscas
+    STATS_SWAPS,        // Trocas de elementos feitas pelas ordenações
+    STATS_RESIZES,      // Redimensionamentos de vetores dinâmicos
+    STATS_ALLOCATIONS,  // Alocações de vetores dinâmicos, arenas e tabelas
+    STATS_COUNTERS      // Quantidade de contadores
+} stats_counter;
+
+/* Fases cronometradas do programa */
+typedef enum StatsPhase
+{
+    STATS_READ,       // Abertura (e mapeamento) dos arquivos
+    STATS_TOKENIZE,   // Leitura das palavras e contagem na tabela (ou cópia para a arena)
+    STATS_SORT,       // Ordenação das palavras (motor "sort")
+    STATS_RUN_LENGTH, // Contagem das repetições consecutivas (motor "sort")
+    STATS_MERGE,      // Mescla dos arquivos temporários (--external)
+    STATS_SELECT,     // Seleção das 'n' palavras mais usadas
+    STATS_OUTPUT,     // Escrita do ranking
+    STATS_PHASES      // Quantidade de fases
+} stats_phase;
+
+#if STATS_ENABLED
+
+/* Contadores da thread atual (somados aos totais por stats_flush) */
+extern _Thread_local uint64_t stats_local[STATS_COUNTERS];
+
+#define STATS_ADD(counter, n) (stats_local[(counter)] += (uint64_t)(n))
+#define STATS_PHASE_BEGIN(phase) stats_phase_begin(phase)
+#define STATS_PHASE_END(phase) stats_phase_end(phase)
+#define STATS_FLUSH() stats_flush()
+
+#else
+
+#define STATS_ADD(counter, n) ((void)0)
+#define STATS_PHASE_BEGIN(phase) ((void)0)
+#define STATS_PHASE_END(phase) ((void)0)
+#define STATS_FLUSH() ((void)0)
+
+#endif /* STATS_ENABLED */
+
+#define STATS_INC(counter) STATS_ADD(counter, 1)
+
+/*-------------------------------------------------------
+    Declarações das funções de estatísticas
+-------------------------------------------------------*/
+
+/* Inicia o cronômetro da fase (use STATS_PHASE_BEGIN) */
+void stats_phase_begin(stats_phase phase);
+
+/* Para o cronômetro da fase, somando o tempo decorrido ao total da fase (use STATS_PHASE_END) */
+void stats_phase_end(stats_phase phase);
+
+/*
+ * Soma os contadores da thread atual aos totais e os zera. Cada thread criada deve chamar
+ * STATS_FLUSH antes de terminar; os contadores da thread principal são somados na impressão.
+ */
+void stats_flush(void);
+
+/*
+ * Escreve em 'out' as estatísticas em JSON: tempo de cada fase (ms), contadores e pico de
+ * memória residente (KiB). Retorna false se o programa foi compilado sem estatísticas.
+ */
+bool stats_print_json(FILE *out);
+
+#endif /* STATS_H */
@@ -0,0 +1,35 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+typedef struct Intthreadpool threadpool;
+
+/*-------------------------------------------------------
+    Declarações das funções do pool de threads
+-------------------------------------------------------*/
+
+/*
+ * Cria um pool com 'threads' threads, contando a thread que chama threadpool_run (que também
+ * trabalha): são criadas 'threads' - 1 threads, que esperam bloqueadas entre as execuções.
+ * Retorna NULL se faltar memória ou não for possível criar as threads.
+ */
+threadpool *threadpool_create(int threads);
+
+/* Retorna a quantidade de threads do pool (incluindo a que chama threadpool_run) */
+int threadpool_threads(threadpool *pool);
+
+/*
+ * Executa task(ctx, chunk) para cada bloco 'chunk' em [0, chunks) e espera todos terminarem.
+ * Cada thread começa por uma faixa contígua de blocos e, quando termina a sua, rouba os blocos
+ * que ainda não começaram das faixas das outras, de forma que blocos mais lentos não deixam
+ * threads paradas. Chamadas de várias threads são executadas uma de cada vez; uma chamada
+ * feita de dentro de uma tarefa do próprio pool executa os blocos na thread atual.
+ */
+void threadpool_run(threadpool *pool, size_t chunks, void (*task)(void *ctx, size_t chunk), void *ctx);
+
+/* Termina as threads e libera a memória do pool */
+void threadpool_free(threadpool *pool);
+
+#endif /* THREADPOOL_H */
@@ -0,0 +1,104 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+/* Macro para o tamanho dos blocos lidos quando o arquivo não pode ser mapeado em memória */
+#define TOKENIZER_BLOCK_SIZE (1 << 20)
+
+typedef struct Inttokenizer tokenizer;
+
+/*
+ * Palavra encontrada pelo tokenizador: uma "visão" (ponteiro e tamanho) do buffer lido,
+ * sem terminador nulo e sem cópia.
+ */
+typedef struct Token
+{
+    const char *ptr; // Início da palavra dentro do buffer
+    size_t len;      // Tamanho da palavra em bytes
+} token;
+
+/*-------------------------------------------------------
+    Declarações das funções do tokenizador
+-------------------------------------------------------*/
+
+/*
+ * Abre o arquivo 'path' e o mapeia em memória. Se não for possível mapear
+ * (pipes, dispositivos...), o arquivo é lido em blocos de TOKENIZER_BLOCK_SIZE bytes.
+ * Arquivos comprimidos com gzip (reconhecidos pela assinatura, não pela extensão) são lidos
+ * em blocos, descomprimidos por uma thread própria enquanto as palavras são contadas.
+ * Retorna NULL caso o arquivo não possa ser aberto.
+ */
+tokenizer *tokenizer_open(const char *path);
+
+/*
+ * Abre o arquivo 'path' para ser lido em blocos, sem mapeá-lo (a memória usada não depende do
+ * tamanho do arquivo). Arquivos gzip são descomprimidos como em tokenizer_open.
+ */
+tokenizer *tokenizer_open_blocks(const char *path);
+
+/*
+ * Cria um tokenizador que lê o descritor 'fd' em blocos (o descritor não é fechado pelo tokenizador).
+ * Se a entrada começar com a assinatura do gzip, ela é descomprimida como em tokenizer_open,
+ * inclusive em pipes (./main 10 - < livro.txt.gz).
+ */
+tokenizer *tokenizer_open_fd(int fd);
+
+/* Cria um tokenizador sobre um buffer já carregado em memória (o buffer não é copiado nem liberado) */
+tokenizer *tokenizer_open_buffer(const char *data, size_t size);
+
+/*
+ * Guarda em 'tok' a próxima palavra. Retorna false quando a entrada termina.
+ * Com o arquivo mapeado (ou um buffer), a visão continua válida até o tokenizador ser fechado;
+ * na leitura em blocos ou com normalização (tokenizer_set_fold), ela só é válida até a próxima chamada.
+ */
+bool tokenizer_next(tokenizer *tk, token *tok);
+
+/*
+ * Retorna o conteúdo inteiro da entrada e guarda seu tamanho em 'size', quando ele está
+ * disponível em memória (arquivo mapeado ou buffer; um arquivo vazio retorna "" com tamanho 0).
+ * Na leitura em blocos, retorna NULL.
+ */
+const char *tokenizer_buffer(tokenizer *tk, size_t *size);
+
+/*
+ * Ajusta 'pos' para a primeira posição, a partir dela, que não está no meio de uma palavra.
+ * Útil para dividir um buffer em partes sem cortar palavras (nem caracteres UTF-8).
+ */
+size_t tokenizer_boundary(const char *data, size_t size, size_t pos);
+
+/*
+ * Retorna a posição onde começa a última palavra de 'data' ('size' se 'data' termina em um
+ * separador). Para ler uma entrada que ainda cresce: os bytes a partir dessa posição podem
+ * ser o começo de uma palavra (ou de um caractere UTF-8) que continua nos próximos bytes,
+ * e devem ser guardados para a próxima leitura.
+ */
+size_t tokenizer_word_start(const char *data, size_t size);
+
+/*
+ * Escolhe o núcleo que classifica os bytes em letras e separadores: "scalar", "sse2" (16 bytes
+ * por vez) ou "avx2" (32 bytes por vez). O mais rápido suportado pelo processador é escolhido
+ * automaticamente na inicialização. Retorna false se o núcleo não for suportado.
+ */
+bool tokenizer_set_kernel(const char *name);
+
+/* Retorna o nome do núcleo de classificação em uso */
+const char *tokenizer_kernel(void);
+
+/*
+ * Ativa ou desativa a normalização nos tokenizadores criados a partir de agora (padrão:
+ * desativada). Normalizando, o texto é decodificado como UTF-8: as palavras são formadas
+ * só por letras ASCII e letras Latin-1 (À a ÿ, sem × e ÷), e todos os outros caracteres, como
+ * "—" e "«»", separam palavras. As letras são convertidas para minúsculas na mesma passada, e
+ * a visão de cada palavra aponta para um buffer do tokenizador, válido até a próxima chamada.
+ */
+void tokenizer_set_fold(bool fold);
+
+/* Retorna true caso tenha ocorrido um erro de leitura */
+bool tokenizer_error(tokenizer *tk);
+
+/* Fecha o arquivo e libera a memória do tokenizador */
+void tokenizer_close(tokenizer *tk);
+
+#endif /* TOKENIZER_H */
@@ -0,0 +1,79 @@
+#ifndef WORDINDEX_H
+#define WORDINDEX_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <Wordmap.h>
+
+/* Macros para a identificação do arquivo de índice */
+#define WORDINDEX_MAGIC "WRANKIDX"
+#define WORDINDEX_VERSION 2
+
+/* Macro para o alinhamento da seção de busca (uma linha de cache) */
+#define WORDINDEX_LOOKUP_ALIGN 64
+
+typedef struct Intwordindex wordindex;
+
+/*
+ * Formato do arquivo (inteiros na ordem de bytes da máquina):
+ *   cabeçalho  wordindex_header
+ *   ranking    'length' x wordindex_record, da palavra mais usada para a menos usada
+ *   busca      'length + 1' x wordlookup_node em layout Eytzinger, alinhados em WORDINDEX_LOOKUP_ALIGN;
+ *              o 'id' de cada nó é a posição da palavra no ranking
+ *   palavras   as palavras, cada uma terminada em '\0'
+ * O arquivo é mapeado em memória na leitura, sem nenhuma conversão.
+ */
+typedef struct WordindexHeader
+{
+    char magic[8];           // WORDINDEX_MAGIC (sem o '\0')
+    uint32_t version;        // WORDINDEX_VERSION
+    uint32_t header_size;    // sizeof(wordindex_header), para detectar arquivos de outra arquitetura
+    uint64_t length;         // Quantidade de palavras distintas
+    uint64_t total;          // Quantidade total de palavras do texto
+    uint64_t ranking_offset; // Início da seção do ranking
+    uint64_t lookup_offset;  // Início da seção de busca
+    uint64_t words_offset;   // Início da seção das palavras
+    uint64_t words_size;     // Tamanho da seção das palavras
+} wordindex_header;
+
+/* Posição do ranking: contagem da palavra e deslocamento dela na seção das palavras */
+typedef struct WordindexRecord
+{
+    uint64_t times; // Quantidade de aparições
+    uint64_t word;  // Deslocamento da palavra a partir de 'words_offset'
+} wordindex_record;
+
+/*-------------------------------------------------------
+    Declarações das funções do índice de palavras
+-------------------------------------------------------*/
+
+/*
+ * Grava em 'path' o índice com todas as palavras da tabela. O arquivo é escrito em
+ * um temporário ao lado e renomeado no final, para nunca existir um índice pela metade.
+ * Retorna false em caso de erro (errno indica a causa).
+ */
+bool wordindex_write(const char *path, wordmap *map);
+
+/* Abre e mapeia em memória o índice 'path'. Retorna NULL se o arquivo não existir ou não for um índice válido */
+wordindex *wordindex_open(const char *path);
+
+/* Retorna a quantidade de palavras distintas do índice */
+size_t wordindex_length(wordindex *ix);
+
+/* Retorna a quantidade total de palavras do texto indexado */
+size_t wordindex_total(wordindex *ix);
+
+/*
+ * Retorna a palavra na posição 'rank' do ranking (0 é a mais usada) e guarda suas
+ * aparições em 'times'. Retorna NULL se a posição for inválida.
+ */
+const char *wordindex_word(wordindex *ix, size_t rank, size_t *times);
+
+/* Retorna a quantidade de aparições da palavra com 'len' bytes; se ela não existir, retorna 0 */
+size_t wordindex_count(wordindex *ix, const char *word, size_t len);
+
+/* Desfaz o mapeamento e libera a memória do índice */
+void wordindex_close(wordindex *ix);
+
+#endif /* WORDINDEX_H */
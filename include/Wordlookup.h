@@ -0,0 +1,66 @@
+#ifndef WORDLOOKUP_H
+#define WORDLOOKUP_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <Wordmap.h>
+
+/* Macro para o valor retornado por wordlookup_find quando a palavra não existe */
+#define WORDLOOKUP_NOT_FOUND ((size_t)-1)
+
+typedef struct Intwordlookup wordlookup;
+
+/*
+ * Nó da árvore de busca em layout Eytzinger (ordem de uma busca em largura): o nó 'k'
+ * tem os filhos '2k' e '2k + 1', e a posição 0 não é usada. A descida percorre o vetor
+ * sempre para a frente, e os netos de um nó ocupam uma única linha de cache (4 nós de 16 bytes).
+ *
+ * Os 8 primeiros bytes da palavra ficam no próprio nó, em big-endian, de forma que
+ * comparar os prefixos como inteiros dá a mesma ordem que strcmp; a palavra completa
+ * só é lida quando os prefixos são iguais e ela tem 8 bytes ou mais.
+ */
+typedef struct WordlookupNode
+{
+    uint64_t prefix; // Primeiros 8 bytes da palavra (completados com zeros)
+    uint32_t word;   // Deslocamento da palavra (terminada em '\0') no bloco de palavras
+    uint32_t id;     // Identificador devolvido pela busca (ex.: posição no ranking)
+} wordlookup_node;
+
+/*-------------------------------------------------------
+    Declarações das funções da busca de palavras
+-------------------------------------------------------*/
+
+/* Calcula o prefixo de comparação de uma palavra com 'len' bytes */
+uint64_t wordlookup_prefix(const char *word, size_t len);
+
+/*
+ * Reorganiza os 'length' nós de 'sorted' (em ordem alfabética) no layout Eytzinger,
+ * em 'nodes', que deve ter espaço para 'length + 1' nós (a posição 0 fica zerada).
+ */
+void wordlookup_layout(wordlookup_node *nodes, const wordlookup_node *sorted, size_t length);
+
+/*
+ * Procura a palavra com 'len' bytes nos 'length' nós em layout Eytzinger. 'words' é o
+ * bloco de 'words_size' bytes com as palavras apontadas pelos nós.
+ * Retorna o 'id' do nó encontrado ou WORDLOOKUP_NOT_FOUND.
+ */
+size_t wordlookup_find(const wordlookup_node *nodes, size_t length, const char *words, size_t words_size,
+                       const char *word, size_t len);
+
+/*
+ * Cria uma estrutura de busca, somente leitura, com todas as palavras da tabela e suas
+ * contagens. A estrutura não depende da tabela depois de criada. Retorna NULL se faltar memória.
+ */
+wordlookup *wordlookup_create(wordmap *map);
+
+/* Retorna a quantidade de aparições da palavra com 'len' bytes; se ela não existir, retorna 0 */
+size_t wordlookup_count(wordlookup *wl, const char *word, size_t len);
+
+/* Retorna a quantidade de palavras da estrutura */
+size_t wordlookup_length(wordlookup *wl);
+
+/* Libera a memória da estrutura de busca */
+void wordlookup_free(wordlookup *wl);
+
+#endif /* WORDLOOKUP_H */
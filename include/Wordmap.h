@@ -0,0 +1,89 @@
+#ifndef WORDMAP_H
+#define WORDMAP_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <GenericDynvec.h>
+#include <Arena.h>
+
+/* Macro para capacidade inicial da tabela (deve ser potência de 2) */
+#define WORDMAP_INIT_CAPACITY 1024
+
+typedef struct Intwordmap wordmap;
+
+/*
+ * Entrada da tabela: cada palavra distinta é guardada uma única vez na arena
+ * da tabela, com seu tamanho, seu hash e a quantidade de aparições.
+ */
+typedef struct WordmapEntry
+{
+    const char *word; // Handle da palavra na arena (terminada em '\0')
+    size_t len;       // Tamanho da palavra, sem o '\0'
+    size_t times;     // Quantidade de aparições
+    uint64_t hash;    // Hash da palavra (evita recalcular no redimensionamento)
+} wordmap_entry;
+
+/*-------------------------------------------------------
+    Declarações das funções da tabela de palavras
+-------------------------------------------------------*/
+
+/* Cria e inicializa uma tabela de palavras vazia */
+wordmap *wordmap_create(void);
+
+/* Calcula o hash de uma palavra com 'len' bytes */
+uint64_t wordmap_hash(const char *word, size_t len);
+
+/*
+ * Soma 'times' às aparições da palavra; se ela ainda não existir, é copiada para a tabela.
+ * Retorna false caso não seja possível alocar memória.
+ */
+bool wordmap_add(wordmap *map, const char *word, size_t len, size_t times);
+
+/*
+ * Soma uma aparição à palavra (como wordmap_add) e retorna a sua entrada. O handle da palavra
+ * ('word') identifica a palavra: é o mesmo em todas as chamadas com a mesma palavra. O ponteiro
+ * para a entrada só é válido até a próxima inserção. Retorna NULL se faltar memória.
+ */
+wordmap_entry *wordmap_intern(wordmap *map, const char *word, size_t len);
+
+/*
+ * Retorna a posição da entrada (como as retornadas por wordmap_intern) no vetor de entradas.
+ * A posição não muda com as inserções, ao contrário do ponteiro: serve para guardar a palavra.
+ */
+size_t wordmap_index(wordmap *map, const wordmap_entry *entry);
+
+/*
+ * Retorna a entrada na posição 'index'. As aparições ('times') podem ser alteradas, por exemplo
+ * para descontar palavras que saíram de uma janela; a palavra e o hash não.
+ */
+wordmap_entry *wordmap_at(wordmap *map, size_t index);
+
+/* Soma à tabela 'dest' as aparições de todas as palavras de 'src'. Retorna false se faltar memória */
+bool wordmap_merge(wordmap *dest, wordmap *src);
+
+/* Retorna a quantidade de aparições da palavra; se ela não existir, retorna 0 */
+size_t wordmap_get(wordmap *map, const char *word, size_t len);
+
+/* Retorna o número de palavras distintas guardadas na tabela */
+size_t wordmap_length(wordmap *map);
+
+/* Retorna a quantidade aproximada de bytes ocupados pela tabela (posições, entradas e palavras) */
+size_t wordmap_memory(wordmap *map);
+
+/*
+ * Compara duas entradas da tabela pela quantidade de aparições, desempatando pela palavra
+ * (função de comparação do ranking, para dynvec_top_k e as ordenações do GenericDynvec)
+ */
+int wordmap_rank_comp(const void *key, const void *elem);
+
+/*
+ * Retorna o vetor (somente leitura) com as entradas da tabela, na ordem de inserção.
+ * Os elementos do vetor são do tipo 'wordmap_entry'.
+ */
+dynvec *wordmap_entries(wordmap *map);
+
+/* Libera a memória alocada para a tabela e suas palavras */
+void wordmap_free(wordmap *map);
+
+#endif /* WORDMAP_H */
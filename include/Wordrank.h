@@ -0,0 +1,51 @@
+#ifndef WORDRANK_H
+#define WORDRANK_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <GenericDynvec.h>
+#include <Wordmap.h>
+
+typedef struct Intwordrank wordrank;
+
+/*-------------------------------------------------------
+    Declarações das funções do ranking incremental
+-------------------------------------------------------*/
+
+/*
+ * Cria um ranking incremental com as 'n' palavras mais usadas da tabela 'map' (que não é
+ * copiada). O ranking é um heap de mínimo indexado: cada palavra da tabela guarda a sua
+ * posição no heap, de forma que uma contagem alterada é reposicionada em O(log n), sem
+ * ordenar o vocabulário. Com 'decreases', as aparições também podem diminuir (janelas
+ * deslizantes): as demais palavras ficam em um heap de máximo indexado, de onde sai a
+ * substituta de uma palavra do ranking que ficou menor, em O(log V).
+ * A tabela deve estar vazia ou ser seguida de wordrank_update para cada uma de suas entradas.
+ * Retorna NULL se faltar memória.
+ */
+wordrank *wordrank_create(wordmap *map, size_t n, bool decreases);
+
+/*
+ * Informa que as aparições da entrada 'entry' da tabela mudaram (ou que ela acabou de ser
+ * inserida, como as entradas retornadas por wordmap_intern). Sem 'decreases', as aparições
+ * só podem ter aumentado. Retorna false se faltar memória.
+ */
+bool wordrank_update(wordrank *wr, const wordmap_entry *entry);
+
+/*
+ * Retorna um novo vetor com as 'n' palavras mais usadas (wordmap_entry), da mais usada para
+ * a menos usada, desempatando pela palavra. Palavras sem aparições não entram.
+ * Retorna NULL se faltar memória.
+ */
+dynvec *wordrank_top(wordrank *wr);
+
+/*
+ * Como wordrank_top, mas escreve o ranking em 'out' (um vetor de wordmap_entry), substituindo o
+ * seu conteúdo. Reaproveitando 'out' a cada consulta, o ranking é emitido sem alocar memória.
+ * Retorna false se faltar memória.
+ */
+bool wordrank_top_into(wordrank *wr, dynvec *out);
+
+/* Libera a memória do ranking (a tabela não é liberada) */
+void wordrank_free(wordrank *wr);
+
+#endif /* WORDRANK_H */
@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <Stats.h>
+#include <Arena.h>
+
+// Bloco de memória da arena, com os dados logo após o cabeçalho
+typedef struct Chunk
+{
+    struct Chunk *next; // Bloco anterior (a lista começa pelo bloco atual)
+    size_t used;        // Bytes já ocupados
+    size_t capacity;    // Bytes disponíveis em 'data'
+    char data[];        // Strings guardadas
+} Chunk;
+
+// Estrutura que representa a arena de strings
+typedef struct Intarena
+{
+    Chunk *head;  // Bloco onde as próximas strings são guardadas
+    size_t bytes; // Total de bytes reservados
+} arena;
+
+// Função auxiliar: adiciona um novo bloco com pelo menos 'min' bytes livres
+static bool arena_grow(arena *a, size_t min)
+{
+    size_t capacity = (min > ARENA_CHUNK_SIZE) ? min : ARENA_CHUNK_SIZE;
+    Chunk *chunk = malloc(sizeof(Chunk) + capacity);
+    if (!chunk)
+        return false;
+    STATS_INC(STATS_ALLOCATIONS);
+    chunk->next = a->head;
+    chunk->used = 0;
+    chunk->capacity = capacity;
+    a->head = chunk;
+    a->bytes += sizeof(Chunk) + capacity;
+    return true;
+}
+
+// Cria uma arena de strings vazia
+arena *arena_create(void)
+{
+    return calloc(1, sizeof(arena));
+}
+
+// Copia a string para a arena, precedida do seu tamanho e seguida de '\0', e retorna seu handle
+const char *arena_store(arena *a, const char *str, size_t len)
+{
+    if (len > UINT32_MAX)
+        return NULL;
+
+    // Cada string ocupa: tamanho (4 bytes) + bytes da string + '\0'
+    size_t needed = sizeof(uint32_t) + len + 1;
+    if (!a->head || a->head->capacity - a->head->used < needed)
+    {
+        if (!arena_grow(a, needed))
+            return NULL;
+    }
+
+    char *dest = a->head->data + a->head->used;
+    uint32_t prefix = (uint32_t)len;
+    memcpy(dest, &prefix, sizeof(uint32_t));
+    memcpy(dest + sizeof(uint32_t), str, len);
+    dest[sizeof(uint32_t) + len] = '\0';
+    a->head->used += needed;
+    return dest + sizeof(uint32_t);
+}
+
+// Reserva 'size' bytes alinhados na arena
+void *arena_alloc(arena *a, size_t size)
+{
+    const size_t align = _Alignof(max_align_t);
+    if (size > SIZE_MAX - align)
+        return NULL;
+
+    // O alinhamento é calculado sobre o endereço, já que as strings deixam 'used' desalinhado
+    size_t pad = a->head ? -(uintptr_t)(a->head->data + a->head->used) & (align - 1) : 0;
+    if (!a->head || a->head->capacity - a->head->used < pad + size)
+    {
+        if (!arena_grow(a, size + align))
+            return NULL;
+        pad = -(uintptr_t)a->head->data & (align - 1);
+    }
+
+    char *dest = a->head->data + a->head->used + pad;
+    a->head->used += pad + size;
+    return dest;
+}
+
+// Retorna o tamanho da string guardada na arena a partir do seu handle
+size_t arena_len(const char *handle)
+{
+    uint32_t prefix;
+    memcpy(&prefix, handle - sizeof(uint32_t), sizeof(uint32_t));
+    return prefix;
+}
+
+// Retorna a quantidade de bytes reservados pela arena
+size_t arena_size(arena *a)
+{
+    return a->bytes;
+}
+
+// Libera todos os blocos da arena
+void arena_free(arena *a)
+{
+    if (!a)
+        return;
+    while (a->head)
+    {
+        Chunk *next = a->head->next;
+        free(a->head);
+        a->head = next;
+    }
+    free(a);
+}
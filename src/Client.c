@@ -0,0 +1,178 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <Server.h>
+
+/*
+ * Cliente do servidor de rankings ("main serve"). Envia o pedido formado pelos argumentos
+ * (ex.: client TOP padre_amaro.txt 10) ou, sem argumentos, cada linha da entrada padrão,
+ * e escreve as respostas. Com --repeat R, envia o mesmo pedido R vezes, descarta as respostas
+ * e escreve a latência (p50, p99 e máxima) e a vazão, para medir o servidor.
+ *
+ * Uso: client [--socket CAMINHO] [--repeat R] [PEDIDO...]
+ */
+
+// Função auxiliar: tempo atual em nanossegundos (relógio monotônico)
+static long long now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Função auxiliar: compara duas latências (para o qsort)
+static int latency_comp(const void *a, const void *b)
+{
+    long long x = *(const long long *)a, y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+// Função auxiliar: conecta ao socket do servidor. Retorna -1 em caso de erro
+static int connect_server(const char *path)
+{
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    if (strlen(path) >= sizeof(addr.sun_path))
+        return -1;
+    strcpy(addr.sun_path, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Função auxiliar: envia um pedido e lê a resposta inteira ("OK <k>" e k linhas, ou "ERR ...").
+// Escreve a resposta em 'echo', se não for NULL. Retorna false se a conexão foi fechada
+static bool request(FILE *to, FILE *from, const char *line, FILE *echo, char **buffer, size_t *capacity)
+{
+    if (fprintf(to, "%s\n", line) < 0 || fflush(to) != 0)
+        return false;
+    if (getline(buffer, capacity, from) <= 0)
+        return false;
+    if (echo)
+        fputs(*buffer, echo);
+
+    unsigned long long lines = 0;
+    if (sscanf(*buffer, "OK %llu", &lines) != 1)
+        return strncmp(*buffer, "ERR", 3) == 0;
+    for (unsigned long long i = 0; i < lines; i++)
+    {
+        if (getline(buffer, capacity, from) <= 0)
+            return false;
+        if (echo)
+            fputs(*buffer, echo);
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *socket_path = SERVER_DEFAULT_SOCKET;
+    long repeat = 0;
+    int first = 1;
+    for (; first < argc; first++)
+    {
+        if (strcmp(argv[first], "--socket") == 0 && first + 1 < argc)
+            socket_path = argv[++first];
+        else if (strcmp(argv[first], "--repeat") == 0 && first + 1 < argc && (repeat = atol(argv[first + 1])) > 0)
+            first++;
+        else if (argv[first][0] == '-')
+        {
+            fprintf(stderr, "Uso: %s [--socket CAMINHO] [--repeat R] [PEDIDO...]\n", argv[0]);
+            return -1;
+        }
+        else
+            break;
+    }
+    if (repeat > 0 && first == argc)
+    {
+        fprintf(stderr, "--repeat precisa de um pedido nos argumentos\n");
+        return -1;
+    }
+
+    // O pedido dos argumentos é uma única linha, com as palavras separadas por espaço
+    char line[SERVER_LINE_MAX];
+    size_t used = 0;
+    for (int i = first; i < argc; i++)
+    {
+        int written = snprintf(line + used, sizeof(line) - used, "%s%s", (i > first) ? " " : "", argv[i]);
+        if (written < 0 || (size_t)written >= sizeof(line) - used)
+        {
+            fprintf(stderr, "Error: request too long\n");
+            return -1;
+        }
+        used += (size_t)written;
+    }
+
+    int fd = connect_server(socket_path);
+    FILE *to = (fd >= 0) ? fdopen(fd, "w") : NULL;
+    FILE *from = to ? fdopen(dup(fd), "r") : NULL;
+    if (!from)
+    {
+        perror("Error connecting to server");
+        return -1;
+    }
+
+    char *buffer = NULL;
+    size_t capacity = 0;
+    bool ok = true;
+    if (repeat > 0)
+    {
+        long long *latencies = malloc(repeat * sizeof(long long));
+        if (!latencies)
+        {
+            perror("Error allocating memory");
+            return -1;
+        }
+        long long start = now_ns();
+        long done = 0;
+        for (; ok && done < repeat; done++)
+        {
+            long long before = now_ns();
+            ok = request(to, from, line, NULL, &buffer, &capacity);
+            latencies[done] = now_ns() - before;
+        }
+        double elapsed = (now_ns() - start) / 1e9;
+
+        qsort(latencies, done, sizeof(long long), latency_comp);
+        if (done > 0)
+            printf("pedidos %ld p50_us %.1f p99_us %.1f max_us %.1f pedidos_s %.0f\n", done,
+                   latencies[done / 2] / 1e3, latencies[(done * 99) / 100] / 1e3, latencies[done - 1] / 1e3,
+                   elapsed > 0 ? done / elapsed : 0);
+        free(latencies);
+    }
+    else if (first < argc)
+        ok = request(to, from, line, stdout, &buffer, &capacity);
+    else
+    {
+        // Sem pedido nos argumentos: cada linha da entrada padrão é um pedido
+        char *input = NULL;
+        size_t input_capacity = 0;
+        ssize_t len;
+        while (ok && (len = getline(&input, &input_capacity, stdin)) > 0)
+        {
+            if (input[len - 1] == '\n')
+                input[len - 1] = '\0';
+            if (strcmp(input, "QUIT") == 0)
+                break;
+            if (input[0] != '\0')
+                ok = request(to, from, input, stdout, &buffer, &capacity);
+        }
+        free(input);
+    }
+
+    if (!ok)
+        fprintf(stderr, "Error: connection closed by server\n");
+    free(buffer);
+    fclose(to);
+    fclose(from);
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,371 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <GenericDynvec.h>
+#include <Arena.h>
+#include <Wordmap.h>
+#include <Tokenizer.h>
+#include <Gzstream.h>
+#include <Stats.h>
+#include <Corpus.h>
+
+// Arquivo lido inteiro para a memória, esperando na fila por uma thread de contagem
+typedef struct Loaded
+{
+    size_t doc;  // Índice do documento
+    char *data;  // Conteúdo do arquivo
+    size_t size; // Tamanho do conteúdo
+} Loaded;
+
+// Estado de uma thread de contagem
+typedef struct Worker
+{
+    corpus *c;    // Corpus sendo contado
+    wordmap *map; // Tabela com as palavras de todos os documentos contados por esta thread
+    arena *words; // Arena com as palavras dos rankings dos documentos contados por esta thread
+    bool ok;      // Indica se não faltou memória
+} Worker;
+
+// Estrutura que representa o corpus
+typedef struct Intcorpus
+{
+    const char **paths;     // Caminhos dos documentos
+    size_t count;           // Quantidade de documentos
+    size_t n;               // Tamanho do ranking de cada documento
+    corpus_document *docs;  // Resultado de cada documento
+    wordmap *total;         // Tabela global
+    Worker *workers;        // Threads de contagem (guardam as arenas dos rankings)
+    int worker_count;       // Quantidade de threads de contagem
+
+    pthread_mutex_t lock;            // Protege a fila e os campos abaixo
+    pthread_cond_t not_full;         // Sinaliza que há espaço na fila
+    pthread_cond_t not_empty;        // Sinaliza que há arquivos na fila (ou que a leitura terminou)
+    Loaded queue[CORPUS_QUEUE_SIZE]; // Fila circular de arquivos lidos
+    size_t head;                     // Posição do primeiro arquivo da fila
+    size_t queued;                   // Quantidade de arquivos na fila
+    size_t next_path;                // Próximo documento a ser lido
+    int readers_left;                // Quantidade de threads de leitura que ainda não terminaram
+} corpus;
+
+/*-------------------------------------------------------
+   Funções auxiliares
+-------------------------------------------------------*/
+
+// Função auxiliar: lê o arquivo inteiro para um buffer alocado (descomprimindo arquivos gzip).
+// Retorna false em caso de erro (errno indica a causa)
+static bool read_file(const char *path, char **data, size_t *size)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    bool compressed = gzstream_detect(fd);
+    gzstream *gz = compressed ? gzstream_open(fd, NULL, 0) : NULL;
+
+    // O tamanho do arquivo é só uma estimativa inicial: arquivos especiais informam 0, e os
+    // arquivos gzip informam o tamanho comprimido
+    struct stat st;
+    size_t capacity = (fstat(fd, &st) == 0 && st.st_size > 0) ? (size_t)st.st_size + 1 : TOKENIZER_BLOCK_SIZE;
+    char *buffer = malloc(capacity);
+    size_t length = 0;
+    bool ok = buffer != NULL && (gz || !compressed);
+    while (ok)
+    {
+        if (length == capacity)
+        {
+            char *temp = realloc(buffer, capacity * 2);
+            if (!temp)
+            {
+                ok = false;
+                break;
+            }
+            buffer = temp;
+            capacity *= 2;
+        }
+        ssize_t count = gz ? gzstream_read(gz, buffer + length, capacity - length) : read(fd, buffer + length, capacity - length);
+        if (count > 0)
+        {
+            length += (size_t)count;
+            STATS_ADD(STATS_BYTES_READ, count);
+        }
+        else if (count == 0)
+            break;
+        else if (errno != EINTR)
+            ok = false;
+    }
+
+    int saved = errno;
+    gzstream_close(gz);
+    close(fd);
+    if (!ok)
+    {
+        free(buffer);
+        errno = saved;
+        return false;
+    }
+    *data = buffer;
+    *size = length;
+    return true;
+}
+
+// Função auxiliar: conta as palavras de um documento, guarda o seu ranking e soma a tabela
+// do documento à tabela da thread
+static void count_document(Worker *worker, Loaded *item)
+{
+    corpus_document *doc = &worker->c->docs[item->doc];
+    tokenizer *tk = tokenizer_open_buffer(item->data, item->size);
+    wordmap *map = wordmap_create();
+    token tok;
+
+    bool ok = tk && map;
+    while (ok && tokenizer_next(tk, &tok))
+    {
+        ok = wordmap_add(map, tok.ptr, tok.len, 1);
+        doc->words++;
+    }
+    tokenizer_close(tk);
+
+    // O ranking é copiado para a arena da thread, pois a tabela do documento é liberada em seguida
+    doc->top = ok ? dynvec_top_k(wordmap_entries(map), worker->c->n, wordmap_rank_comp) : NULL;
+    ok = doc->top != NULL;
+    for (size_t i = 0; ok && i < dynvec_length(doc->top); i++)
+    {
+        wordmap_entry *entry = (wordmap_entry *)dynvec_get(doc->top, i);
+        entry->word = arena_store(worker->words, entry->word, entry->len);
+        ok = entry->word != NULL;
+    }
+    ok = ok && wordmap_merge(worker->map, map);
+
+    doc->unique = map ? wordmap_length(map) : 0;
+    doc->ok = ok;
+    doc->error = ok ? 0 : ENOMEM;
+    worker->ok = worker->ok && ok;
+    wordmap_free(map);
+}
+
+// Thread de leitura: lê os próximos documentos ainda não lidos e os coloca na fila
+static void *reader_thread(void *arg)
+{
+    corpus *c = (corpus *)arg;
+    for (;;)
+    {
+        pthread_mutex_lock(&c->lock);
+        size_t doc = c->next_path;
+        if (doc < c->count)
+            c->next_path++;
+        pthread_mutex_unlock(&c->lock);
+        if (doc >= c->count)
+            break;
+
+        Loaded item = {doc, NULL, 0};
+        if (!read_file(c->paths[doc], &item.data, &item.size))
+        {
+            c->docs[doc].error = errno;
+            continue;
+        }
+
+        // Espera espaço na fila: a memória usada fica limitada a CORPUS_QUEUE_SIZE arquivos lidos
+        pthread_mutex_lock(&c->lock);
+        while (c->queued == CORPUS_QUEUE_SIZE)
+            pthread_cond_wait(&c->not_full, &c->lock);
+        c->queue[(c->head + c->queued) % CORPUS_QUEUE_SIZE] = item;
+        c->queued++;
+        pthread_cond_signal(&c->not_empty);
+        pthread_mutex_unlock(&c->lock);
+    }
+
+    // A última thread de leitura acorda as threads de contagem que esperam uma fila que não vai mais encher
+    pthread_mutex_lock(&c->lock);
+    if (--c->readers_left == 0)
+        pthread_cond_broadcast(&c->not_empty);
+    pthread_mutex_unlock(&c->lock);
+    STATS_FLUSH();
+    return NULL;
+}
+
+// Thread de contagem: tira os arquivos da fila e conta as suas palavras, até a leitura terminar
+static void *worker_thread(void *arg)
+{
+    Worker *worker = (Worker *)arg;
+    corpus *c = worker->c;
+    for (;;)
+    {
+        pthread_mutex_lock(&c->lock);
+        while (c->queued == 0 && c->readers_left > 0)
+            pthread_cond_wait(&c->not_empty, &c->lock);
+        if (c->queued == 0)
+        {
+            pthread_mutex_unlock(&c->lock);
+            break;
+        }
+        Loaded item = c->queue[c->head];
+        c->head = (c->head + 1) % CORPUS_QUEUE_SIZE;
+        c->queued--;
+        pthread_cond_signal(&c->not_full);
+        pthread_mutex_unlock(&c->lock);
+
+        count_document(worker, &item);
+        free(item.data);
+    }
+    STATS_FLUSH();
+    return NULL;
+}
+
+/*-------------------------------------------------------
+   Funções do corpus
+-------------------------------------------------------*/
+
+// Conta as palavras dos documentos com o pipeline de leitura e contagem
+corpus *corpus_count(const char **paths, size_t count, size_t n, int readers, int workers)
+{
+    // Não há motivo para ter mais threads do que documentos
+    if ((size_t)readers > count)
+        readers = count > 0 ? (int)count : 1;
+    if ((size_t)workers > count)
+        workers = count > 0 ? (int)count : 1;
+    if (readers < 1)
+        readers = 1;
+    if (workers < 1)
+        workers = 1;
+
+    corpus *c = calloc(1, sizeof(corpus));
+    if (!c)
+        return NULL;
+    pthread_mutex_init(&c->lock, NULL);
+    pthread_cond_init(&c->not_full, NULL);
+    pthread_cond_init(&c->not_empty, NULL);
+    c->paths = paths;
+    c->count = count;
+    c->n = n;
+    c->docs = calloc(count + 1, sizeof(corpus_document));
+    c->workers = calloc(workers, sizeof(Worker));
+    pthread_t *ids = malloc((readers + workers) * sizeof(pthread_t));
+    if (!c->docs || !c->workers || !ids)
+    {
+        free(ids);
+        corpus_free(c);
+        return NULL;
+    }
+    for (size_t i = 0; i < count; i++)
+        c->docs[i].path = paths[i];
+    c->readers_left = readers;
+
+    // Threads de contagem: cada uma tem a sua tabela, juntadas no final
+    bool ok = true;
+    for (int i = 0; ok && i < workers; i++)
+    {
+        Worker *worker = &c->workers[i];
+        worker->c = c;
+        worker->map = wordmap_create();
+        worker->words = arena_create();
+        worker->ok = worker->map && worker->words;
+        ok = worker->ok;
+        int error = ok ? pthread_create(&ids[i], NULL, worker_thread, worker) : ENOMEM;
+        if (error != 0)
+        {
+            // Sem nenhuma thread de contagem o pipeline não anda; com pelo menos uma, segue com menos
+            wordmap_free(worker->map);
+            arena_free(worker->words);
+            worker->map = NULL;
+            worker->words = NULL;
+            ok = i > 0;
+            errno = error;
+            break;
+        }
+        c->worker_count++;
+    }
+    if (!ok)
+    {
+        // Faz as threads já criadas terminarem: nenhuma leitura será feita
+        pthread_mutex_lock(&c->lock);
+        c->readers_left = 0;
+        pthread_cond_broadcast(&c->not_empty);
+        pthread_mutex_unlock(&c->lock);
+        for (int i = 0; i < c->worker_count; i++)
+            pthread_join(ids[i], NULL);
+        free(ids);
+        corpus_free(c);
+        return NULL;
+    }
+
+    // Threads de leitura. Caso não seja possível criar todas, as restantes rodam nesta thread
+    // (a primeira delas já lê todos os documentos que sobrarem)
+    int started = 0;
+    for (; started < readers; started++)
+    {
+        if (pthread_create(&ids[c->worker_count + started], NULL, reader_thread, c) != 0)
+            break;
+    }
+    for (int i = started; i < readers; i++)
+        reader_thread(c);
+
+    for (int i = 0; i < started; i++)
+        pthread_join(ids[c->worker_count + i], NULL);
+    for (int i = 0; i < c->worker_count; i++)
+        pthread_join(ids[i], NULL);
+    free(ids);
+
+    // Junta as tabelas das threads na tabela da primeira
+    c->total = c->workers[0].map;
+    c->workers[0].map = NULL;
+    ok = c->workers[0].ok;
+    for (int i = 1; i < c->worker_count; i++)
+    {
+        ok = ok && c->workers[i].ok && wordmap_merge(c->total, c->workers[i].map);
+        wordmap_free(c->workers[i].map);
+        c->workers[i].map = NULL;
+    }
+    if (!ok)
+    {
+        corpus_free(c);
+        errno = ENOMEM;
+        return NULL;
+    }
+    return c;
+}
+
+// Retorna a quantidade de documentos
+size_t corpus_length(corpus *c)
+{
+    return c->count;
+}
+
+// Retorna o resultado do documento 'i'
+corpus_document *corpus_get(corpus *c, size_t i)
+{
+    return (i < c->count) ? &c->docs[i] : NULL;
+}
+
+// Retorna a tabela global
+wordmap *corpus_total(corpus *c)
+{
+    return c->total;
+}
+
+// Libera a memória do corpus e de todos os resultados
+void corpus_free(corpus *c)
+{
+    if (!c)
+        return;
+    for (size_t i = 0; c->docs && i < c->count; i++)
+        dynvec_free(c->docs[i].top);
+    for (int i = 0; c->workers && i < c->worker_count; i++)
+    {
+        wordmap_free(c->workers[i].map);
+        arena_free(c->workers[i].words);
+    }
+    pthread_mutex_destroy(&c->lock);
+    pthread_cond_destroy(&c->not_full);
+    pthread_cond_destroy(&c->not_empty);
+    wordmap_free(c->total);
+    free(c->docs);
+    free(c->workers);
+    free(c);
+}
@@ -0,0 +1,396 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <GenericDynvec.h>
+#include <Arena.h>
+#include <Wordmap.h>
+#include <External.h>
+
+// Arquivo temporário com uma sequência (run) de pares (palavra, contagem) ordenada por palavra.
+// Cada registro é: tamanho (uint32_t), bytes da palavra, contagem (uint64_t).
+typedef struct Run
+{
+    FILE *file;      // Arquivo temporário (já removido do diretório)
+    char *word;      // Palavra do registro atual (terminada em '\0')
+    size_t len;      // Tamanho da palavra atual
+    size_t capacity; // Capacidade do buffer 'word'
+    uint64_t times;  // Contagem do registro atual
+    char *buffer;    // Buffer de E/S do arquivo
+    size_t level;    // Nível do run: 0 para os gravados da tabela, L + 1 para a mescla de runs do nível L
+} Run;
+
+// Resultado da leitura de um registro do run
+typedef enum RunStatus
+{
+    RUN_RECORD, // Registro lido
+    RUN_END,    // Fim do run
+    RUN_ERROR   // Falta de memória, erro de leitura ou registro truncado
+} run_status;
+
+// Estrutura que representa a contagem em disco
+typedef struct Intexternal
+{
+    wordmap *map;  // Tabela em memória
+    size_t budget; // Orçamento de memória da tabela
+    dynvec *runs;  // Arquivos temporários gravados (Run)
+} external;
+
+// Par (palavra, contagem) da tabela gravado em um run
+typedef struct Entry
+{
+    const char *word; // Palavra na arena da tabela (terminada em '\0')
+    size_t times;     // Quantidade de aparições
+} entry;
+
+// Chave de ordenação do par: a palavra (inlinada pelo DYNVEC_DEFINE_STRING_SORT)
+static inline const char *entry_word(const entry *item)
+{
+    return item->word;
+}
+
+DYNVEC_DEFINE_STRING_SORT(entry, entry, entry_word)
+
+/*-------------------------------------------------------
+   Funções auxiliares
+-------------------------------------------------------*/
+
+// Função auxiliar: cria um arquivo temporário anônimo em $TMPDIR (ou /tmp)
+static FILE *create_temp_file(void)
+{
+    const char *dir = getenv("TMPDIR");
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/ranking-run-XXXXXX", (dir && *dir) ? dir : "/tmp");
+    int fd = mkstemp(path);
+    if (fd < 0)
+        return NULL;
+    unlink(path); // O arquivo some assim que for fechado
+    FILE *file = fdopen(fd, "w+b");
+    if (!file)
+        close(fd);
+    return file;
+}
+
+// Função auxiliar: cria um run vazio, com arquivo temporário e buffer de E/S próprios
+static bool run_create(Run *run, size_t level)
+{
+    *run = (Run){create_temp_file(), NULL, 0, 0, 0, malloc(EXTERNAL_IO_BUFFER), level};
+    if (!run->file || !run->buffer)
+    {
+        free(run->buffer);
+        if (run->file)
+            fclose(run->file);
+        return false;
+    }
+    setvbuf(run->file, run->buffer, _IOFBF, EXTERNAL_IO_BUFFER);
+    return true;
+}
+
+// Função auxiliar: fecha o arquivo do run e libera seus buffers
+static void run_close(Run *run)
+{
+    fclose(run->file);
+    free(run->buffer);
+    free(run->word);
+}
+
+// Função auxiliar: grava um registro no run 'ctx' (tem a assinatura de external_emit)
+static bool run_write(const char *word, size_t len, size_t times, void *ctx)
+{
+    Run *run = (Run *)ctx;
+    uint32_t len32 = (uint32_t)len;
+    uint64_t times64 = times;
+    return fwrite(&len32, sizeof(len32), 1, run->file) == 1 &&
+           fwrite(word, 1, len, run->file) == len &&
+           fwrite(&times64, sizeof(times64), 1, run->file) == 1;
+}
+
+// Função auxiliar: grava a tabela em memória como um novo run ordenado e a esvazia
+static bool spill(external *ex)
+{
+    dynvec *entries = wordmap_entries(ex->map);
+    size_t length = dynvec_length(entries);
+    entry *pairs = malloc(length * sizeof(entry));
+    Run run;
+    if (!pairs || !run_create(&run, 0))
+    {
+        free(pairs);
+        return false;
+    }
+
+    // Ordena os pares (palavra, contagem) pela palavra: a contagem vai junto, sem nova busca na tabela
+    for (size_t i = 0; i < length; i++)
+    {
+        wordmap_entry *e = (wordmap_entry *)dynvec_get(entries, i);
+        pairs[i] = (entry){e->word, e->times};
+    }
+    entry_sort_strings(pairs, length);
+
+    bool ok = true;
+    for (size_t i = 0; i < length && ok; i++)
+        ok = run_write(pairs[i].word, arena_len(pairs[i].word), pairs[i].times, &run);
+    free(pairs);
+    ok = ok && fflush(run.file) == 0 && dynvec_push(ex->runs, &run);
+    if (!ok)
+    {
+        run_close(&run);
+        return false;
+    }
+
+    wordmap_free(ex->map);
+    ex->map = wordmap_create();
+    return ex->map != NULL;
+}
+
+// Função auxiliar: lê o próximo registro do run. Retorna RUN_END só no fim do arquivo entre dois
+// registros; falta de memória, erro de leitura ou registro truncado retornam RUN_ERROR (com errno)
+static run_status run_next(Run *run)
+{
+    uint32_t len;
+    size_t got = fread(&len, 1, sizeof(len), run->file);
+    if (got == 0 && !ferror(run->file))
+        return RUN_END;
+    if (got != sizeof(len))
+    {
+        errno = EIO;
+        return RUN_ERROR;
+    }
+    if (len + 1 > run->capacity)
+    {
+        char *temp = realloc(run->word, len + 1);
+        if (!temp)
+        {
+            errno = ENOMEM;
+            return RUN_ERROR;
+        }
+        run->word = temp;
+        run->capacity = len + 1;
+    }
+    if (fread(run->word, 1, len, run->file) != len || fread(&run->times, sizeof(run->times), 1, run->file) != 1)
+    {
+        errno = EIO;
+        return RUN_ERROR;
+    }
+    run->word[len] = '\0';
+    run->len = len;
+    return RUN_RECORD;
+}
+
+// Função auxiliar: desce a posição 'i' no heap de runs (ordenado pela palavra atual de cada run)
+static void run_sift_down(Run **heap, size_t length, size_t i)
+{
+    for (;;)
+    {
+        size_t smallest = i, l = 2 * i + 1, r = 2 * i + 2;
+        if (l < length && strcmp(heap[l]->word, heap[smallest]->word) < 0)
+            smallest = l;
+        if (r < length && strcmp(heap[r]->word, heap[smallest]->word) < 0)
+            smallest = r;
+        if (smallest == i)
+            return;
+        Run *temp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = temp;
+        i = smallest;
+    }
+}
+
+// Função auxiliar: mescla os runs a partir da posição 'first' (k-way merge) somando as contagens
+// e chama 'emit' para cada palavra distinta, em ordem crescente
+static bool merge_runs(external *ex, size_t first, external_emit emit, void *ctx)
+{
+    size_t count = dynvec_length(ex->runs) - first;
+    Run **heap = malloc(count * sizeof(Run *));
+    if (!heap)
+        return false;
+
+    size_t length = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        Run *run = (Run *)dynvec_get(ex->runs, first + i);
+        rewind(run->file);
+        run_status status = run_next(run);
+        if (status == RUN_ERROR)
+        {
+            free(heap);
+            return false;
+        }
+        if (status == RUN_RECORD)
+            heap[length++] = run;
+    }
+    for (size_t i = length / 2; i > 0; i--)
+        run_sift_down(heap, length, i - 1);
+
+    // A menor palavra está sempre na raiz; as contagens de palavras iguais são somadas
+    bool ok = true;
+    char *current = NULL;
+    size_t current_len = 0, current_capacity = 0, current_times = 0;
+    while (length > 0 && ok)
+    {
+        Run *run = heap[0];
+        if (current && current_len == run->len && memcmp(current, run->word, run->len) == 0)
+            current_times += run->times;
+        else
+        {
+            if (current)
+                ok = emit(current, current_len, current_times, ctx);
+            if (run->len + 1 > current_capacity)
+            {
+                char *temp = realloc(current, run->len + 1);
+                if (!temp)
+                {
+                    ok = false;
+                    break;
+                }
+                current = temp;
+                current_capacity = run->len + 1;
+            }
+            memcpy(current, run->word, run->len + 1);
+            current_len = run->len;
+            current_times = run->times;
+        }
+
+        run_status status = run_next(run);
+        if (status == RUN_ERROR)
+        {
+            ok = false;
+            break;
+        }
+        if (status == RUN_END)
+            heap[0] = heap[--length];
+        run_sift_down(heap, length, 0);
+    }
+    if (ok && current)
+        ok = emit(current, current_len, current_times, ctx);
+
+    // Um erro de leitura em qualquer run invalida o resultado
+    for (size_t i = 0; i < count; i++)
+        ok = ok && !ferror(((Run *)dynvec_get(ex->runs, first + i))->file);
+
+    free(current);
+    free(heap);
+    return ok;
+}
+
+// Função auxiliar: mescla os runs a partir da posição 'first' em um só, do nível 'level'
+static bool compact(external *ex, size_t first, size_t level)
+{
+    Run merged;
+    if (!run_create(&merged, level))
+        return false;
+    if (!merge_runs(ex, first, run_write, &merged) || fflush(merged.file) != 0)
+    {
+        run_close(&merged);
+        return false;
+    }
+    Run run;
+    while (dynvec_length(ex->runs) > first && dynvec_pop_into(ex->runs, &run))
+        run_close(&run);
+    if (!dynvec_push(ex->runs, &merged))
+    {
+        run_close(&merged);
+        return false;
+    }
+    return true;
+}
+
+// Função auxiliar: mescla em níveis. Os runs ficam em ordem de nível decrescente, então os do
+// último nível estão sempre no fim do vetor: quando chegam a EXTERNAL_MERGE_FANIN, viram um run
+// do nível seguinte, que pode completar o seu nível também. Cada palavra é regravada uma vez por
+// nível, O(log(runs)) vezes no total, em vez de a cada mescla de todos os runs.
+static bool compact_levels(external *ex)
+{
+    for (;;)
+    {
+        size_t length = dynvec_length(ex->runs);
+        size_t level = ((Run *)dynvec_get(ex->runs, length - 1))->level;
+        size_t first = length - 1;
+        while (first > 0 && ((Run *)dynvec_get(ex->runs, first - 1))->level == level)
+            first--;
+        if (length - first >= EXTERNAL_MERGE_FANIN)
+        {
+            if (!compact(ex, first, level + 1))
+                return false;
+        }
+        // Limite de arquivos abertos: só com muitos níveis (EXTERNAL_MERGE_FANIN^níveis runs gravados)
+        else if (length >= EXTERNAL_MAX_RUNS)
+            return compact(ex, 0, ((Run *)dynvec_get(ex->runs, 0))->level + 1);
+        else
+            return true;
+    }
+}
+
+/*-------------------------------------------------------
+   Funções da contagem em disco
+-------------------------------------------------------*/
+
+// Cria um contador de palavras com orçamento de memória 'budget'
+external *external_create(size_t budget)
+{
+    external *ex = malloc(sizeof(external));
+    if (!ex)
+        return NULL;
+    // Abaixo do mínimo, a tabela vazia já passaria do orçamento e cada palavra viraria um run
+    ex->budget = budget < EXTERNAL_MIN_BUDGET ? EXTERNAL_MIN_BUDGET : budget;
+    ex->map = wordmap_create();
+    ex->runs = dynvec_create(sizeof(Run));
+    if (!ex->map || !ex->runs)
+    {
+        external_free(ex);
+        return NULL;
+    }
+    return ex;
+}
+
+// Registra uma aparição da palavra, gravando a tabela em disco quando ela passa do orçamento
+bool external_add(external *ex, const char *word, size_t len)
+{
+    if (!wordmap_add(ex->map, word, len, 1))
+        return false;
+    if (wordmap_memory(ex->map) <= ex->budget)
+        return true;
+    return spill(ex) && compact_levels(ex);
+}
+
+// Mescla os runs somando as contagens e chama 'emit' para cada palavra distinta
+bool external_finish(external *ex, external_emit emit, void *ctx)
+{
+    // Sem nenhum run, a tabela em memória já tem as contagens exatas
+    if (dynvec_length(ex->runs) == 0)
+    {
+        dynvec *entries = wordmap_entries(ex->map);
+        for (size_t i = 0; i < dynvec_length(entries); i++)
+        {
+            wordmap_entry *entry = (wordmap_entry *)dynvec_get(entries, i);
+            if (!emit(entry->word, entry->len, entry->times, ctx))
+                return false;
+        }
+        return true;
+    }
+
+    // O restante da tabela vira o último run
+    if (wordmap_length(ex->map) > 0 && !spill(ex))
+        return false;
+    return merge_runs(ex, 0, emit, ctx);
+}
+
+// Retorna a quantidade de arquivos temporários gravados
+size_t external_runs(external *ex)
+{
+    return dynvec_length(ex->runs);
+}
+
+// Libera a memória e apaga os arquivos temporários
+void external_free(external *ex)
+{
+    if (!ex)
+        return;
+    for (size_t i = 0; ex->runs && i < dynvec_length(ex->runs); i++)
+        run_close((Run *)dynvec_get(ex->runs, i));
+    dynvec_free(ex->runs);
+    wordmap_free(ex->map);
+    free(ex);
+}
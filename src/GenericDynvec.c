@@ -1,20 +1,52 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <Stats.h>
+#include <Arena.h>
+#include <Threadpool.h>
+#include <GenericDynvec.h>
 
-// Capacidade inicial do vetor dinâmico
-#define DYNVEC_INIT_CAPACITY 8
+// Tamanho do buffer na pilha utilizado para trocar elementos
+#define SWAP_BUFFER_SIZE 64
+
+// Tamanho das partições ordenadas por inserção no quicksort
+#define INSERTION_SORT_CUTOFF 16
+
+// Tamanho mínimo (em elementos) para dividir o mergesort ou o merge entre threads
+#define PARALLEL_CUTOFF 8192
+
+// Menor classe de tamanho do pool (2^4 = 16 bytes) e quantidade de classes
+#define POOL_MIN_CLASS 4
+#define POOL_CLASSES 48
 
 // Estrutura que representa o vetor dinâmico genérico
 typedef struct Intdynvec
 {
-    void *data;       // Ponteiro para os elementos
-    size_t elem_size; // Tamanho de cada elemento
-    size_t capacity;  // Capacidade atual do vetor
-    size_t length;    // Número de elementos armazenados
+    void *data;                        // Ponteiro para os elementos
+    size_t elem_size;                  // Tamanho de cada elemento
+    size_t capacity;                   // Capacidade atual do vetor
+    size_t length;                     // Número de elementos armazenados
+    size_t reserved;                   // Capacidade mínima: as reduções nunca ficam abaixo dela
+    const dynvec_allocator *allocator; // Alocador da estrutura e dos elementos
 } dynvec;
 
+// Bloco livre guardado no pool (o ponteiro para o próximo fica no início do próprio bloco)
+typedef struct PoolBlock
+{
+    struct PoolBlock *next;
+} PoolBlock;
+
+// Estrutura que representa o pool de blocos
+typedef struct Intdynvec_pool
+{
+    PoolBlock *free[POOL_CLASSES]; // Blocos livres de cada classe (a classe c tem 2^c bytes)
+    dynvec_allocator allocator;    // Alocador que usa o pool
+} dynvec_pool;
+
 // Estrutura auxiliar para particionamento (utilizada no quicksort 3-way)
 typedef struct Limits
 {
@@ -22,53 +54,255 @@ typedef struct Limits
     size_t right;
 } Limits;
 
+/*-------------------------------------------------------
+   Alocadores
+-------------------------------------------------------*/
+
+// Função auxiliar: aloca com malloc
+static void *system_alloc(void *ctx, size_t size)
+{
+    (void)ctx;
+    void *ptr = malloc(size);
+    if (ptr)
+        STATS_INC(STATS_ALLOCATIONS);
+    return ptr;
+}
+
+// Função auxiliar: redimensiona com realloc
+static void *system_resize(void *ctx, void *ptr, size_t old_size, size_t new_size)
+{
+    (void)ctx;
+    (void)old_size;
+    void *temp = realloc(ptr, new_size);
+    if (temp)
+        STATS_INC(STATS_ALLOCATIONS);
+    return temp;
+}
+
+// Função auxiliar: libera com free
+static void system_release(void *ctx, void *ptr, size_t size)
+{
+    (void)ctx;
+    (void)size;
+    free(ptr);
+}
+
+// Alocador do sistema
+const dynvec_allocator dynvec_system_allocator = {system_alloc, system_resize, system_release, NULL};
+
+// Função auxiliar: classe de tamanho do pool para blocos de 'size' bytes (a menor potência de 2 que cabe)
+static size_t pool_class(size_t size)
+{
+    size_t c = POOL_MIN_CLASS;
+    while (c < POOL_CLASSES && ((size_t)1 << c) < size)
+        c++;
+    return c;
+}
+
+// Função auxiliar: retira um bloco livre da classe ou, se não houver, aloca um novo
+static void *pool_alloc(void *ctx, size_t size)
+{
+    dynvec_pool *pool = (dynvec_pool *)ctx;
+    size_t c = pool_class(size);
+    if (c >= POOL_CLASSES)
+        return NULL;
+    PoolBlock *block = pool->free[c];
+    if (block)
+    {
+        pool->free[c] = block->next;
+        return block;
+    }
+    return system_alloc(NULL, (size_t)1 << c);
+}
+
+// Função auxiliar: devolve o bloco à lista da sua classe
+static void pool_release(void *ctx, void *ptr, size_t size)
+{
+    dynvec_pool *pool = (dynvec_pool *)ctx;
+    if (!ptr)
+        return;
+    PoolBlock *block = (PoolBlock *)ptr;
+    size_t c = pool_class(size);
+    block->next = pool->free[c];
+    pool->free[c] = block;
+}
+
+// Função auxiliar: mantém o bloco se o novo tamanho for da mesma classe; senão, troca de bloco
+static void *pool_resize(void *ctx, void *ptr, size_t old_size, size_t new_size)
+{
+    if (ptr && pool_class(old_size) == pool_class(new_size))
+        return ptr;
+    void *block = pool_alloc(ctx, new_size);
+    if (!block)
+        return NULL;
+    if (ptr)
+    {
+        memcpy(block, ptr, (old_size < new_size) ? old_size : new_size);
+        pool_release(ctx, ptr, old_size);
+    }
+    return block;
+}
+
+// Cria um pool de blocos vazio
+dynvec_pool *dynvec_pool_create(void)
+{
+    dynvec_pool *pool = calloc(1, sizeof(dynvec_pool));
+    if (!pool)
+        return NULL;
+    pool->allocator = (dynvec_allocator){pool_alloc, pool_resize, pool_release, pool};
+    return pool;
+}
+
+// Retorna o alocador do pool
+const dynvec_allocator *dynvec_pool_allocator(dynvec_pool *pool)
+{
+    return &pool->allocator;
+}
+
+// Libera o pool e os blocos livres guardados nele
+void dynvec_pool_free(dynvec_pool *pool)
+{
+    if (!pool)
+        return;
+    for (size_t c = 0; c < POOL_CLASSES; c++)
+    {
+        while (pool->free[c])
+        {
+            PoolBlock *next = pool->free[c]->next;
+            free(pool->free[c]);
+            pool->free[c] = next;
+        }
+    }
+    free(pool);
+}
+
+// Função auxiliar: reserva o bloco na arena
+static void *arena_block_alloc(void *ctx, size_t size)
+{
+    return arena_alloc((arena *)ctx, size);
+}
+
+// Função auxiliar: o bloco só cresce (copiando para um novo bloco da arena), o antigo fica na arena
+static void *arena_block_resize(void *ctx, void *ptr, size_t old_size, size_t new_size)
+{
+    if (ptr && new_size <= old_size)
+        return ptr;
+    void *block = arena_alloc((arena *)ctx, new_size);
+    if (block && ptr)
+        memcpy(block, ptr, old_size);
+    return block;
+}
+
+// Função auxiliar: a memória da arena só é liberada junto com ela
+static void arena_block_release(void *ctx, void *ptr, size_t size)
+{
+    (void)ctx;
+    (void)ptr;
+    (void)size;
+}
+
+// Retorna um alocador que reserva os blocos na arena
+dynvec_allocator dynvec_arena_allocator(arena *a)
+{
+    return (dynvec_allocator){arena_block_alloc, arena_block_resize, arena_block_release, a};
+}
+
 /*-------------------------------------------------------
    Funções de manipulação do vetor dinâmico (dynvec)
 -------------------------------------------------------*/
 
-// Função auxiliar: troca os elementos nas posições 'a' e 'b' do vetor
+// Função auxiliar: troca os elementos nas posições 'a' e 'b' do vetor.
+// A troca é feita em pedaços através de um buffer na pilha, sem alocar memória.
 static void swap(dynvec *vec, size_t a, size_t b)
 {
-    if (!vec || !vec->data || vec->elem_size == 0)
+    if (!vec || !vec->data || a == b)
         return;
+    STATS_INC(STATS_SWAPS);
+
+    char *pa = (char *)vec->data + a * vec->elem_size;
+    char *pb = (char *)vec->data + b * vec->elem_size;
 
-    void *temp = malloc(vec->elem_size);
-    if (!temp)
+    // Elementos do tamanho de uma palavra (ponteiros, size_t) são trocados diretamente
+    if (vec->elem_size == sizeof(uint64_t))
+    {
+        uint64_t temp;
+        memcpy(&temp, pa, sizeof(uint64_t));
+        memcpy(pa, pb, sizeof(uint64_t));
+        memcpy(pb, &temp, sizeof(uint64_t));
         return;
+    }
 
-    memcpy(temp, (char *)vec->data + a * vec->elem_size, vec->elem_size);
-    memcpy((char *)vec->data + a * vec->elem_size, (char *)vec->data + b * vec->elem_size, vec->elem_size);
-    memcpy((char *)vec->data + b * vec->elem_size, temp, vec->elem_size);
-    free(temp);
+    char temp[SWAP_BUFFER_SIZE];
+    for (size_t remaining = vec->elem_size; remaining > 0;)
+    {
+        size_t chunk = (remaining < SWAP_BUFFER_SIZE) ? remaining : SWAP_BUFFER_SIZE;
+        memcpy(temp, pa, chunk);
+        memcpy(pa, pb, chunk);
+        memcpy(pb, temp, chunk);
+        pa += chunk;
+        pb += chunk;
+        remaining -= chunk;
+    }
 }
 
 // Função auxiliar: redimensiona o vetor para a nova capacidade
 static bool dynvec_resize(dynvec *vec, size_t new_capacity)
 {
-    void *temp = realloc(vec->data, new_capacity * vec->elem_size);
+    void *temp = vec->allocator->resize(vec->allocator->ctx, vec->data, vec->capacity * vec->elem_size,
+                                        new_capacity * vec->elem_size);
     if (temp == NULL)
     {
         return false; // Falha ao redimensionar
     }
+    STATS_INC(STATS_RESIZES);
     vec->data = temp;
     vec->capacity = new_capacity;
     return true;
 }
 
+// Função auxiliar: garante capacidade para 'n' elementos, dobrando a capacidade até caber
+static bool dynvec_grow(dynvec *vec, size_t n)
+{
+    if (n <= vec->capacity)
+        return true;
+    if (n > SIZE_MAX / 2 / vec->elem_size)
+        return false;
+    size_t capacity = vec->capacity;
+    while (capacity < n)
+        capacity *= 2;
+    return dynvec_resize(vec, capacity);
+}
+
+// Função auxiliar: reduz a capacidade à metade quando o vetor ocupa no máximo 1/DYNVEC_SHRINK_FACTOR
+// dela, sem ficar abaixo da capacidade reservada. Uma falha ao reduzir não é um erro
+static void dynvec_shrink(dynvec *vec)
+{
+    if (vec->length <= vec->capacity / DYNVEC_SHRINK_FACTOR && vec->capacity / 2 >= vec->reserved)
+        dynvec_resize(vec, vec->capacity / 2);
+}
+
 // Cria e inicializa um vetor dinâmico com o tamanho de elemento especificado
 dynvec *dynvec_create(size_t elem_size)
 {
-    dynvec *vec = malloc(sizeof(dynvec));
+    return dynvec_create_with(elem_size, &dynvec_system_allocator);
+}
+
+// Cria e inicializa um vetor dinâmico cuja memória vem do alocador especificado
+dynvec *dynvec_create_with(size_t elem_size, const dynvec_allocator *allocator)
+{
+    dynvec *vec = allocator->alloc(allocator->ctx, sizeof(dynvec));
     if (!vec)
         return NULL;
 
     vec->capacity = DYNVEC_INIT_CAPACITY;
+    vec->reserved = DYNVEC_INIT_CAPACITY;
     vec->length = 0;
     vec->elem_size = elem_size;
-    vec->data = malloc(vec->elem_size * vec->capacity);
+    vec->allocator = allocator;
+    vec->data = allocator->alloc(allocator->ctx, vec->elem_size * vec->capacity);
     if (!vec->data)
     {
-        free(vec);
+        allocator->release(allocator->ctx, vec, sizeof(dynvec));
         return NULL;
     }
     return vec;
@@ -87,6 +321,52 @@ bool dynvec_push(dynvec *vec, void *item)
     return true;
 }
 
+// Insere no final do vetor 'count' elementos consecutivos
+bool dynvec_push_n(dynvec *vec, const void *items, size_t count)
+{
+    if (count > SIZE_MAX - vec->length || !dynvec_grow(vec, vec->length + count))
+        return false;
+    memcpy((char *)vec->data + vec->elem_size * vec->length, items, count * vec->elem_size);
+    vec->length += count;
+    return true;
+}
+
+// Insere no final de 'dst' todos os elementos de 'src'
+bool dynvec_extend(dynvec *dst, dynvec *src)
+{
+    if (dst->elem_size != src->elem_size)
+        return false;
+    // Os dados de 'src' só são lidos depois do crescimento, que os move quando 'src' é o próprio 'dst'
+    size_t count = src->length;
+    if (count > SIZE_MAX - dst->length || !dynvec_grow(dst, dst->length + count))
+        return false;
+    memcpy((char *)dst->data + dst->elem_size * dst->length, src->data, count * dst->elem_size);
+    dst->length += count;
+    return true;
+}
+
+// Garante capacidade para pelo menos 'n' elementos, que passa a ser a capacidade mínima
+bool dynvec_reserve(dynvec *vec, size_t n)
+{
+    if (!dynvec_grow(vec, n))
+        return false;
+    if (n > vec->reserved)
+        vec->reserved = n;
+    return true;
+}
+
+// Remove o último elemento, copiando-o para 'out' (se não for NULL)
+bool dynvec_pop_into(dynvec *vec, void *out)
+{
+    if (vec->length == 0)
+        return false;
+    vec->length--;
+    if (out)
+        memcpy(out, (char *)vec->data + vec->length * vec->elem_size, vec->elem_size);
+    dynvec_shrink(vec);
+    return true;
+}
+
 // Remove e retorna uma cópia do último elemento do vetor
 void *dynvec_pop(dynvec *vec)
 {
@@ -96,15 +376,7 @@ void *dynvec_pop(dynvec *vec)
     void *value = malloc(vec->elem_size);
     if (!value)
         return NULL;
-
-    memcpy(value, (char *)vec->data + (vec->length - 1) * vec->elem_size, vec->elem_size);
-    vec->length--;
-
-    // Reduz a capacidade se o número de elementos for pequeno
-    if (vec->length <= vec->capacity / 4)
-    {
-        dynvec_resize(vec, vec->capacity / 2);
-    }
+    dynvec_pop_into(vec, value);
     return value;
 }
 
@@ -158,11 +430,7 @@ bool dynvec_delete(dynvec *vec, size_t i)
             (char *)vec->data + (i + 1) * vec->elem_size,
             (vec->length - i - 1) * vec->elem_size);
     vec->length--;
-
-    if (vec->length <= vec->capacity / 4)
-    {
-        dynvec_resize(vec, vec->capacity / 2);
-    }
+    dynvec_shrink(vec);
     return true;
 }
 
@@ -173,7 +441,7 @@ bool dynvec_contains(dynvec *vec, void *elem, int (*cmp)(const void *, const voi
         return false;
     for (size_t i = 0; i < vec->length; i++)
     {
-        if (cmp((char *)vec->data + i * vec->elem_size, elem))
+        if (DYNVEC_COMPARE(cmp, (char *)vec->data + i * vec->elem_size, elem))
             return true;
     }
     return false;
@@ -186,7 +454,7 @@ size_t dynvec_index(dynvec *vec, void *elem, int (*cmp)(const void *, const void
         return -1;
     for (size_t i = 0; i < vec->length; i++)
     {
-        if (cmp((char *)vec->data + i * vec->elem_size, elem))
+        if (DYNVEC_COMPARE(cmp, (char *)vec->data + i * vec->elem_size, elem))
             return i;
     }
     return -1;
@@ -256,7 +524,7 @@ dynvec *dynvec_filter(dynvec *vec, bool (*predicate)(void *))
 {
     if (!vec || !predicate)
         return NULL;
-    dynvec *new_vec = dynvec_create(vec->elem_size);
+    dynvec *new_vec = dynvec_create_with(vec->elem_size, vec->allocator);
     if (!new_vec)
         return NULL;
     for (size_t i = 0; i < vec->length; i++)
@@ -268,36 +536,38 @@ dynvec *dynvec_filter(dynvec *vec, bool (*predicate)(void *))
     return new_vec;
 }
 
-// Busca linear: retorna o índice do elemento que corresponde à chave; se não encontrado, retorna -1
-int dynvec_lsearch(dynvec *vec, void *key, int (*cmp)(const void *, const void *))
+// Busca linear: retorna o índice do elemento que corresponde à chave; se não encontrado, retorna (size_t)-1
+size_t dynvec_lsearch(dynvec *vec, void *key, int (*cmp)(const void *, const void *))
 {
     size_t size = vec->length;
     for (size_t i = 0; i < size; i++)
     {
         void *elem = (char *)vec->data + i * vec->elem_size;
-        if (cmp(key, elem) == 0)
+        if (DYNVEC_COMPARE(cmp, key, elem) == 0)
             return i;
     }
-    return -1;
+    return (size_t)-1;
 }
 
-// Busca binária (o vetor deve estar ordenado): retorna o índice do elemento que corresponde à chave; se não encontrado, retorna -1
-int dynvec_bsearch(dynvec *vec, void *key, int (*cmp)(const void *, const void *))
+// Busca binária (o vetor deve estar ordenado): retorna o índice do elemento que corresponde à chave; se não encontrado, retorna (size_t)-1
+size_t dynvec_bsearch(dynvec *vec, void *key, int (*cmp)(const void *, const void *))
 {
-    size_t low = 0, high = (vec->length) - 1, mid;
-    while (low <= high)
+    // Intervalo semiaberto [low, high): não há 'high - 1' que possa dar a volta quando o vetor
+    // está vazio ou quando a chave é menor que o primeiro elemento
+    size_t low = 0, high = vec->length;
+    while (low < high)
     {
-        mid = low + (high - low) / 2;
+        size_t mid = low + (high - low) / 2;
         void *elem = (char *)vec->data + mid * vec->elem_size;
-        int comparision = cmp(key, elem);
+        int comparision = DYNVEC_COMPARE(cmp, key, elem);
         if (comparision == 0)
             return mid;
         if (comparision < 0)
-            high = mid - 1;
+            high = mid;
         else
             low = mid + 1;
     }
-    return -1;
+    return (size_t)-1;
 }
 
 // Libera a memória alocada para o vetor dinâmico
@@ -305,8 +575,9 @@ void dynvec_free(dynvec *vec)
 {
     if (vec)
     {
-        free(vec->data);
-        free(vec);
+        const dynvec_allocator *allocator = vec->allocator;
+        allocator->release(allocator->ctx, vec->data, vec->capacity * vec->elem_size);
+        allocator->release(allocator->ctx, vec, sizeof(dynvec));
     }
 }
 
@@ -331,17 +602,279 @@ size_t dynvec_elem_size(dynvec *vec)
 // Retorna true se a operação foi bem-sucedida.
 bool dynvec_empty(dynvec *vec)
 {
-    free(vec->data);
+    vec->allocator->release(vec->allocator->ctx, vec->data, vec->capacity * vec->elem_size);
     vec->capacity = DYNVEC_INIT_CAPACITY;
+    vec->reserved = DYNVEC_INIT_CAPACITY;
     vec->length = 0;
-    vec->data = malloc(vec->elem_size * vec->capacity);
+    vec->data = vec->allocator->alloc(vec->allocator->ctx, vec->elem_size * vec->capacity);
     return (vec->data != NULL);
 }
 
+// Remove todos os elementos, mantendo a capacidade atual
+void dynvec_clear(dynvec *vec)
+{
+    vec->length = 0;
+}
+
+/*-------------------------------------------------------
+   Funções paralelas
+-------------------------------------------------------*/
+
+// Divisão do vetor em blocos para as funções paralelas
+typedef struct Chunks
+{
+    dynvec *vec;
+    size_t size;  // Elementos por bloco (o último pode ter menos)
+    size_t count; // Quantidade de blocos
+} Chunks;
+
+// Tarefa de uma função paralela (cada função usa só os campos de que precisa)
+typedef struct ParallelTask
+{
+    Chunks chunks;
+    void (*processo)(void *);            // dynvec_map_parallel
+    bool (*predicate)(void *);           // filter, forall e exists
+    void (*func)(void *acc, void *elem); // dynvec_fold_parallel
+    char *partials;                      // Acumulador parcial de cada bloco (fold)
+    size_t acc_size;                     // Tamanho de cada acumulador parcial (fold)
+    unsigned char *marks;                // Resultado do predicado para cada elemento (filter)
+    size_t *counts;                      // Elementos selecionados de cada bloco, depois as posições (filter)
+    char *out;                           // Elementos do vetor filtrado (filter)
+    bool wanted;                         // Valor do predicado procurado (forall e exists)
+    atomic_bool found;                   // Algum bloco encontrou o valor procurado
+} ParallelTask;
+
+// Função auxiliar: divide o vetor em blocos de pelo menos DYNVEC_PARALLEL_CHUNK elementos, em
+// número suficiente para que o roubo de trabalho equilibre blocos mais lentos (8 por thread)
+static Chunks make_chunks(dynvec *vec, threadpool *pool)
+{
+    size_t target = pool ? (size_t)threadpool_threads(pool) * 8 : 1;
+    size_t size = (vec->length + target - 1) / target;
+    if (size < DYNVEC_PARALLEL_CHUNK)
+        size = DYNVEC_PARALLEL_CHUNK;
+    return (Chunks){vec, size, (vec->length + size - 1) / size};
+}
+
+// Função auxiliar: primeiro elemento e quantidade de elementos do bloco
+static inline char *chunk_range(const Chunks *chunks, size_t chunk, size_t *count)
+{
+    size_t first = chunk * chunks->size;
+    size_t last = first + chunks->size;
+    *count = ((last < chunks->vec->length) ? last : chunks->vec->length) - first;
+    return (char *)chunks->vec->data + first * chunks->vec->elem_size;
+}
+
+// Função auxiliar: executa a tarefa nas threads do pool ou, sem pool, na thread atual
+static void run_chunks(ParallelTask *task, threadpool *pool, void (*fn)(void *ctx, size_t chunk))
+{
+    if (pool)
+        threadpool_run(pool, task->chunks.count, fn, task);
+    else
+    {
+        for (size_t chunk = 0; chunk < task->chunks.count; chunk++)
+            fn(task, chunk);
+    }
+}
+
+// Função auxiliar: aplica a função de processamento nos elementos do bloco
+static void map_chunk(void *ctx, size_t chunk)
+{
+    ParallelTask *task = (ParallelTask *)ctx;
+    size_t count, elem_size = task->chunks.vec->elem_size;
+    char *elem = chunk_range(&task->chunks, chunk, &count);
+    for (size_t i = 0; i < count; i++, elem += elem_size)
+        task->processo(elem);
+}
+
+// Aplica uma função de processamento em cada elemento do vetor, em paralelo
+void dynvec_map_parallel(dynvec *vec, void (*processo)(void *), threadpool *pool)
+{
+    if (!vec || !processo)
+        return;
+    ParallelTask task = {.chunks = make_chunks(vec, pool), .processo = processo};
+    run_chunks(&task, pool, map_chunk);
+}
+
+// Função auxiliar: acumula os elementos do bloco no seu acumulador parcial
+static void fold_chunk(void *ctx, size_t chunk)
+{
+    ParallelTask *task = (ParallelTask *)ctx;
+    size_t count, elem_size = task->chunks.vec->elem_size;
+    char *elem = chunk_range(&task->chunks, chunk, &count);
+    void *partial = task->partials + chunk * task->acc_size;
+    for (size_t i = 0; i < count; i++, elem += elem_size)
+        task->func(partial, elem);
+}
+
+// Fold em paralelo: acumuladores parciais por bloco, combinados na ordem dos blocos
+bool dynvec_fold_parallel(dynvec *vec, void *acc, size_t acc_size, const void *identity,
+                          void (*func)(void *acc, void *elem), void (*combine)(void *acc, const void *partial),
+                          threadpool *pool)
+{
+    if (!vec || !acc || !identity || !func || !combine)
+        return false;
+    ParallelTask task = {.chunks = make_chunks(vec, pool), .func = func, .acc_size = acc_size};
+    task.partials = malloc(task.chunks.count * acc_size + 1);
+    if (!task.partials)
+        return false;
+    for (size_t chunk = 0; chunk < task.chunks.count; chunk++)
+        memcpy(task.partials + chunk * acc_size, identity, acc_size);
+
+    run_chunks(&task, pool, fold_chunk);
+    for (size_t chunk = 0; chunk < task.chunks.count; chunk++)
+        combine(acc, task.partials + chunk * acc_size);
+    free(task.partials);
+    return true;
+}
+
+// Função auxiliar: avalia o predicado nos elementos do bloco, guardando o resultado e a contagem
+static void filter_mark_chunk(void *ctx, size_t chunk)
+{
+    ParallelTask *task = (ParallelTask *)ctx;
+    size_t count, elem_size = task->chunks.vec->elem_size, selected = 0;
+    char *elem = chunk_range(&task->chunks, chunk, &count);
+    unsigned char *marks = task->marks + chunk * task->chunks.size;
+    for (size_t i = 0; i < count; i++, elem += elem_size)
+    {
+        marks[i] = task->predicate(elem);
+        selected += marks[i];
+    }
+    task->counts[chunk] = selected;
+}
+
+// Função auxiliar: copia os elementos selecionados do bloco para a sua posição no resultado
+static void filter_copy_chunk(void *ctx, size_t chunk)
+{
+    ParallelTask *task = (ParallelTask *)ctx;
+    size_t count, elem_size = task->chunks.vec->elem_size;
+    char *elem = chunk_range(&task->chunks, chunk, &count);
+    const unsigned char *marks = task->marks + chunk * task->chunks.size;
+    char *out = task->out + task->counts[chunk] * elem_size;
+    for (size_t i = 0; i < count; i++, elem += elem_size)
+    {
+        if (marks[i])
+        {
+            memcpy(out, elem, elem_size);
+            out += elem_size;
+        }
+    }
+}
+
+// Cria um novo vetor com os elementos que satisfazem o predicado, em paralelo e na mesma ordem
+dynvec *dynvec_filter_parallel(dynvec *vec, bool (*predicate)(void *), threadpool *pool)
+{
+    if (!vec || !predicate)
+        return NULL;
+    ParallelTask task = {.chunks = make_chunks(vec, pool), .predicate = predicate};
+    dynvec *new_vec = dynvec_create_with(vec->elem_size, vec->allocator);
+    task.marks = malloc(vec->length + 1);
+    task.counts = malloc((task.chunks.count + 1) * sizeof(size_t));
+    bool ok = new_vec && task.marks && task.counts;
+
+    if (ok)
+    {
+        run_chunks(&task, pool, filter_mark_chunk);
+
+        // Soma de prefixos (exclusiva): a contagem de cada bloco passa a ser a sua posição no resultado
+        size_t total = 0;
+        for (size_t chunk = 0; chunk < task.chunks.count; chunk++)
+        {
+            size_t selected = task.counts[chunk];
+            task.counts[chunk] = total;
+            total += selected;
+        }
+        ok = dynvec_grow(new_vec, total);
+        if (ok)
+        {
+            task.out = new_vec->data;
+            run_chunks(&task, pool, filter_copy_chunk);
+            new_vec->length = total;
+        }
+    }
+    free(task.marks);
+    free(task.counts);
+    if (!ok)
+    {
+        dynvec_free(new_vec);
+        return NULL;
+    }
+    return new_vec;
+}
+
+// Função auxiliar: procura no bloco um elemento cujo predicado tenha o valor procurado,
+// desistindo quando outro bloco já o encontrou
+static void search_chunk(void *ctx, size_t chunk)
+{
+    ParallelTask *task = (ParallelTask *)ctx;
+    size_t count, elem_size = task->chunks.vec->elem_size;
+    char *elem = chunk_range(&task->chunks, chunk, &count);
+    for (size_t i = 0; i < count; i++, elem += elem_size)
+    {
+        if (atomic_load_explicit(&task->found, memory_order_relaxed))
+            return;
+        if (task->predicate(elem) == task->wanted)
+        {
+            atomic_store_explicit(&task->found, true, memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+// Função auxiliar: verifica em paralelo se algum elemento tem o predicado com o valor 'wanted'
+static bool search_parallel(dynvec *vec, bool (*predicate)(void *), bool wanted, threadpool *pool)
+{
+    ParallelTask task = {.chunks = make_chunks(vec, pool), .predicate = predicate, .wanted = wanted};
+    atomic_init(&task.found, false);
+    run_chunks(&task, pool, search_chunk);
+    return atomic_load(&task.found);
+}
+
+// Verifica em paralelo se todos os elementos satisfazem o predicado
+bool dynvec_forall_parallel(dynvec *vec, bool (*predicate)(void *), threadpool *pool)
+{
+    if (!vec || !predicate)
+        return false;
+    return !search_parallel(vec, predicate, false, pool);
+}
+
+// Verifica em paralelo se existe ao menos um elemento que satisfaz o predicado
+bool dynvec_exists_parallel(dynvec *vec, bool (*predicate)(void *), threadpool *pool)
+{
+    if (!vec || !predicate)
+        return false;
+    return search_parallel(vec, predicate, true, pool);
+}
+
 /*-------------------------------------------------------
    Funções de ordenação
 -------------------------------------------------------*/
 
+// Função auxiliar: retorna o índice da mediana entre os elementos 'a', 'b' e 'c'
+static size_t median_of_three(dynvec *vec, int (*cmp)(const void *, const void *), size_t a, size_t b, size_t c)
+{
+    void *pa = (char *)vec->data + a * vec->elem_size;
+    void *pb = (char *)vec->data + b * vec->elem_size;
+    void *pc = (char *)vec->data + c * vec->elem_size;
+    if (DYNVEC_COMPARE(cmp, pa, pb) < 0)
+        return (DYNVEC_COMPARE(cmp, pb, pc) < 0) ? b : (DYNVEC_COMPARE(cmp, pa, pc) < 0) ? c : a;
+    return (DYNVEC_COMPARE(cmp, pa, pc) < 0) ? a : (DYNVEC_COMPARE(cmp, pb, pc) < 0) ? c : b;
+}
+
+// Função auxiliar: escolhe o pivô com a mediana de 3 ou, em partições grandes, com a mediana de 3 medianas (ninther)
+static size_t choose_pivot(dynvec *vec, int (*cmp)(const void *, const void *), size_t left, size_t right)
+{
+    size_t n = right - left + 1, mid = left + n / 2;
+    if (n > 40)
+    {
+        size_t step = n / 8;
+        size_t a = median_of_three(vec, cmp, left, left + step, left + 2 * step);
+        size_t b = median_of_three(vec, cmp, mid - step, mid, mid + step);
+        size_t c = median_of_three(vec, cmp, right - 2 * step, right - step, right);
+        return median_of_three(vec, cmp, a, b, c);
+    }
+    return median_of_three(vec, cmp, left, mid, right);
+}
+
 // Particiona o vetor em três partes (<, =, >) em relação ao pivô
 // Utiliza a técnica quicksort 3-way para melhorar desempenho em casos com muitos elementos iguais
 static Limits partition_three_way(dynvec *vec, int (*cmp)(const void *, const void *), size_t left, size_t right)
@@ -349,18 +882,14 @@ static Limits partition_three_way(dynvec *vec, int (*cmp)(const void *, const vo
     size_t i = left + 1;
     Limits limite = {left, right};
 
-    // Escolhe um pivô aleatório e o posiciona no início
-    size_t r_pivot = left + rand() % (right - left + 1);
-    swap(vec, r_pivot, left);
-
-    // Copia o valor do pivô para uma variável auxiliar
-    void *pivot = malloc(vec->elem_size);
-    memcpy(pivot, (char *)vec->data + left * vec->elem_size, vec->elem_size);
+    // Posiciona o pivô no início
+    swap(vec, choose_pivot(vec, cmp, left, right), left);
 
-    // Particiona o vetor comparando cada elemento com o pivô
+    // Particiona o vetor comparando cada elemento com o pivô. Os elementos em [limite.left, i)
+    // são todos iguais ao pivô, então 'limite.left' sempre aponta para uma cópia dele (sem alocar)
     while (i <= limite.right)
     {
-        int comp = cmp((char *)vec->data + i * vec->elem_size, pivot);
+        int comp = DYNVEC_COMPARE(cmp, (char *)vec->data + i * vec->elem_size, (char *)vec->data + limite.left * vec->elem_size);
         if (comp < 0)
         {
             swap(vec, i, limite.left);
@@ -377,21 +906,96 @@ static Limits partition_three_way(dynvec *vec, int (*cmp)(const void *, const vo
             i++;
         }
     }
-    free(pivot);
     return limite;
 }
 
-// Quicksort utilizando particionamento 3-way para ordenar o vetor dinâmico
+// Função auxiliar: ordena por inserção o intervalo [left, right] (usada em partições pequenas)
+static void insertion_sort(dynvec *vec, int (*cmp)(const void *, const void *), size_t left, size_t right)
+{
+    for (size_t i = left + 1; i <= right; i++)
+    {
+        for (size_t j = i; j > left && DYNVEC_COMPARE(cmp, (char *)vec->data + j * vec->elem_size, (char *)vec->data + (j - 1) * vec->elem_size) < 0; j--)
+            swap(vec, j, j - 1);
+    }
+}
+
+// Função auxiliar: desce o elemento 'i' no heap de máximo que começa em 'base' e tem 'length' elementos
+static void sift_down_max(dynvec *vec, int (*cmp)(const void *, const void *), size_t base, size_t i, size_t length)
+{
+    for (;;)
+    {
+        size_t largest = i, l = 2 * i + 1, r = 2 * i + 2;
+        if (l < length && DYNVEC_COMPARE(cmp, (char *)vec->data + (base + l) * vec->elem_size, (char *)vec->data + (base + largest) * vec->elem_size) > 0)
+            largest = l;
+        if (r < length && DYNVEC_COMPARE(cmp, (char *)vec->data + (base + r) * vec->elem_size, (char *)vec->data + (base + largest) * vec->elem_size) > 0)
+            largest = r;
+        if (largest == i)
+            return;
+        swap(vec, base + i, base + largest);
+        i = largest;
+    }
+}
+
+// Função auxiliar: heapsort do intervalo [left, right], usado quando a recursão do quicksort fica profunda demais
+static void heapsort_range(dynvec *vec, int (*cmp)(const void *, const void *), size_t left, size_t right)
+{
+    size_t length = right - left + 1;
+    for (size_t i = length / 2; i > 0; i--)
+        sift_down_max(vec, cmp, left, i - 1, length);
+    for (size_t end = length - 1; end > 0; end--)
+    {
+        swap(vec, left, left + end);
+        sift_down_max(vec, cmp, left, 0, end);
+    }
+}
+
+// Função auxiliar: introsort com particionamento 3-way. Recursão apenas na menor partição
+// (a maior continua no laço) e heapsort quando 'depth' chega a zero, garantindo O(n log n)
+static void introsort_three_way(dynvec *vec, int (*cmp)(const void *, const void *), size_t left, size_t right, size_t depth)
+{
+    while (right > left && right - left >= INSERTION_SORT_CUTOFF)
+    {
+        if (depth == 0)
+        {
+            heapsort_range(vec, cmp, left, right);
+            return;
+        }
+        depth--;
+
+        Limits l = partition_three_way(vec, cmp, left, right);
+        size_t left_size = l.left - left, right_size = right - l.right;
+        if (left_size < right_size)
+        {
+            if (left_size > 1)
+                introsort_three_way(vec, cmp, left, l.left - 1, depth);
+            left = l.right + 1;
+        }
+        else
+        {
+            if (right_size > 1)
+                introsort_three_way(vec, cmp, l.right + 1, right, depth);
+            if (left_size == 0)
+                return;
+            right = l.left - 1;
+        }
+    }
+    if (right > left)
+        insertion_sort(vec, cmp, left, right);
+}
+
+// Quicksort utilizando particionamento 3-way para ordenar o vetor dinâmico.
+// Não aloca memória durante a ordenação e tem pior caso O(n log n) (introsort).
 void quicksort_dynvec_three_way(dynvec *vec, int (*cmp)(const void *, const void *), size_t left, size_t right)
 {
     if (!vec || !cmp || !vec->data || vec->elem_size <= 1)
         return;
     if (left < right)
     {
-        Limits l = partition_three_way(vec, cmp, left, right);
-        if (l.left > left)
-            quicksort_dynvec_three_way(vec, cmp, left, l.left - 1);
-        quicksort_dynvec_three_way(vec, cmp, l.right + 1, right);
+        // Profundidade máxima: 2 * log2(n)
+        size_t depth = 0;
+        for (size_t n = right - left + 1; n > 1; n >>= 1)
+            depth += 2;
+        introsort_three_way(vec, cmp, left, right, depth);
     }
 }
 
@@ -400,10 +1004,10 @@ static void merge(dynvec *vec, int (*cmp)(const void *, const void *), size_t le
 {
     size_t i = left, j = mid;
 
-    if (cmp((char *)(temp) + (j - 1) * vec->elem_size, (char *)(temp) + j * vec->elem_size) < 0) // Já está ordenado
+    if (DYNVEC_COMPARE(cmp, (char *)(temp) + (j - 1) * vec->elem_size, (char *)(temp) + j * vec->elem_size) < 0) // Já está ordenado
         return;
 
-    else if (cmp((char *)(temp) + i * vec->elem_size, (char *)(temp) + (right - 1) * vec->elem_size) > 0)
+    else if (DYNVEC_COMPARE(cmp, (char *)(temp) + i * vec->elem_size, (char *)(temp) + (right - 1) * vec->elem_size) > 0)
     {
         memcpy((char *)(vec->data) + left * vec->elem_size, (char *)(temp) + j * vec->elem_size, (right - j) * vec->elem_size);
         memcpy((char *)(vec->data) + (left + (right - j)) * vec->elem_size, (char *)(temp) + i * vec->elem_size, (j - i) * vec->elem_size);
@@ -415,7 +1019,7 @@ static void merge(dynvec *vec, int (*cmp)(const void *, const void *), size_t le
         void *elem1 = (char *)temp + i * vec->elem_size;
         void *elem2 = (char *)temp + j * vec->elem_size;
         void *target = (char *)vec->data + k * vec->elem_size;
-        if (i < mid && (j == right || cmp(elem1, elem2) <= 0))
+        if (i < mid && (j == right || DYNVEC_COMPARE(cmp, elem1, elem2) <= 0))
         {
             memcpy(target, elem1, vec->elem_size);
             i++;
@@ -442,3 +1046,261 @@ void mergesort_dynvec(dynvec *vec, void *temp_data, int (*cmp)(const void *, con
     memcpy((char *)temp_data + left * vec->elem_size, (char *)vec->data + left * vec->elem_size, (right - left) * vec->elem_size);
     merge(vec, cmp, left, right, mid, temp_data);
 }
+
+// Tarefa do mergesort paralelo: ordenar [left, right) ou mesclar duas sequências de 'temp' em 'out'
+typedef struct MergeTask
+{
+    dynvec *vec;
+    void *temp;
+    int (*cmp)(const void *, const void *);
+    const char *a, *b; // Sequências a serem mescladas
+    size_t na, nb;     // Tamanho das sequências
+    char *out;         // Destino da mescla
+    size_t left, right;
+    int threads;
+} MergeTask;
+
+// Função auxiliar: mescla de forma estável a[0..na) e b[0..nb) em 'out' (em caso de empate, 'a' vem antes)
+static void merge_runs(size_t elem_size, int (*cmp)(const void *, const void *), const char *a, size_t na, const char *b, size_t nb, char *out)
+{
+    size_t i = 0, j = 0;
+    while (i < na && j < nb)
+    {
+        if (DYNVEC_COMPARE(cmp, a + i * elem_size, b + j * elem_size) <= 0)
+        {
+            memcpy(out, a + i * elem_size, elem_size);
+            i++;
+        }
+        else
+        {
+            memcpy(out, b + j * elem_size, elem_size);
+            j++;
+        }
+        out += elem_size;
+    }
+    memcpy(out, a + i * elem_size, (na - i) * elem_size);
+    memcpy(out + (na - i) * elem_size, b + j * elem_size, (nb - j) * elem_size);
+}
+
+// Função auxiliar: primeira posição de s[0..n) cujo elemento é >= 'key' (se 'upper', > 'key')
+static size_t search_bound(size_t elem_size, int (*cmp)(const void *, const void *), const char *s, size_t n, const void *key, bool upper)
+{
+    size_t low = 0, high = n;
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        int comp = DYNVEC_COMPARE(cmp, s + mid * elem_size, key);
+        if (comp < 0 || (upper && comp == 0))
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+static void *parallel_merge_task(void *arg);
+
+// Função auxiliar: mescla a[0..na) e b[0..nb) em 'out', dividindo o trabalho entre 'threads' threads.
+// O elemento do meio da maior sequência é procurado na outra, o que separa duas mesclas independentes;
+// a busca respeita a estabilidade (iguais de 'a' ficam antes dos iguais de 'b').
+static void parallel_merge(MergeTask *task)
+{
+    size_t elem_size = task->vec->elem_size;
+    if (task->threads <= 1 || task->na + task->nb < PARALLEL_CUTOFF)
+    {
+        merge_runs(elem_size, task->cmp, task->a, task->na, task->b, task->nb, task->out);
+        return;
+    }
+
+    size_t ma, mb;
+    if (task->na >= task->nb)
+    {
+        ma = task->na / 2;
+        mb = search_bound(elem_size, task->cmp, task->b, task->nb, task->a + ma * elem_size, false);
+    }
+    else
+    {
+        mb = task->nb / 2;
+        ma = search_bound(elem_size, task->cmp, task->a, task->na, task->b + mb * elem_size, true);
+    }
+
+    MergeTask low = *task, high = *task;
+    low.na = ma;
+    low.nb = mb;
+    low.threads = task->threads / 2;
+    high.a += ma * elem_size;
+    high.na -= ma;
+    high.b += mb * elem_size;
+    high.nb -= mb;
+    high.out += (ma + mb) * elem_size;
+    high.threads = task->threads - low.threads;
+
+    pthread_t id;
+    bool spawned = (pthread_create(&id, NULL, parallel_merge_task, &low) == 0);
+    parallel_merge(&high);
+    if (spawned)
+        pthread_join(id, NULL);
+    else
+        parallel_merge(&low);
+}
+
+// Função auxiliar: ponto de entrada das threads do merge paralelo
+static void *parallel_merge_task(void *arg)
+{
+    parallel_merge((MergeTask *)arg);
+    STATS_FLUSH();
+    return NULL;
+}
+
+static void *parallel_sort_task(void *arg);
+
+// Função auxiliar: ordena [left, right) dividindo as metades e o merge entre 'threads' threads
+static void parallel_sort(MergeTask *task)
+{
+    dynvec *vec = task->vec;
+    size_t left = task->left, right = task->right;
+    if (task->threads <= 1 || right - left < PARALLEL_CUTOFF)
+    {
+        mergesort_dynvec(vec, task->temp, task->cmp, left, right);
+        return;
+    }
+
+    size_t mid = left + (right - left) / 2;
+    MergeTask low = *task, high = *task;
+    low.right = mid;
+    low.threads = task->threads / 2;
+    high.left = mid;
+    high.threads = task->threads - low.threads;
+
+    // A metade esquerda é ordenada em uma nova thread e a direita na atual
+    pthread_t id;
+    bool spawned = (pthread_create(&id, NULL, parallel_sort_task, &low) == 0);
+    parallel_sort(&high);
+    if (spawned)
+        pthread_join(id, NULL);
+    else
+        parallel_sort(&low);
+
+    // Copia a parte a ser mesclada para o vetor auxiliar e mescla em paralelo de volta para o vetor
+    size_t elem_size = vec->elem_size;
+    char *temp = task->temp;
+    memcpy(temp + left * elem_size, (char *)vec->data + left * elem_size, (right - left) * elem_size);
+
+    MergeTask merge_task = *task;
+    merge_task.a = temp + left * elem_size;
+    merge_task.na = mid - left;
+    merge_task.b = temp + mid * elem_size;
+    merge_task.nb = right - mid;
+    merge_task.out = (char *)vec->data + left * elem_size;
+    parallel_merge(&merge_task);
+}
+
+// Função auxiliar: ponto de entrada das threads do mergesort paralelo
+static void *parallel_sort_task(void *arg)
+{
+    parallel_sort((MergeTask *)arg);
+    STATS_FLUSH();
+    return NULL;
+}
+
+// Mergesort paralelo, com o mesmo contrato de mergesort_dynvec
+void mergesort_dynvec_parallel(dynvec *vec, void *temp_data, int (*cmp)(const void *, const void *), size_t left, size_t right, int threads)
+{
+    if (!vec || !cmp || !vec->data || vec->elem_size <= 1 || right <= left || right - left <= 1)
+        return;
+
+    MergeTask task = {vec, temp_data, cmp, NULL, NULL, 0, 0, NULL, left, right, threads};
+    parallel_sort(&task);
+}
+
+// Função auxiliar: a string é a própria chave do multikey quicksort
+static inline const char *string_key(const char *const *s)
+{
+    return *s;
+}
+
+// Multikey quicksort de strings, com o particionamento do DYNVEC_DEFINE_STRING_SORT
+DYNVEC_DEFINE_STRING_SORT(const char *, string, string_key)
+
+// Ordena strings com o multikey quicksort
+void multikey_quicksort(const char **strings, size_t n)
+{
+    if (strings && n > 1)
+        string_sort_strings(strings, n);
+}
+
+// Ordena com o multikey quicksort um vetor dinâmico de 'char *'
+void dynvec_sort_strings(dynvec *vec)
+{
+    if (!vec || !vec->data || vec->elem_size != sizeof(char *))
+        return;
+    multikey_quicksort((const char **)vec->data, vec->length);
+}
+
+// Função auxiliar: desce o elemento 'i' no heap de mínimo guardado em 'heap' até restaurar a propriedade do heap
+static void sift_down(dynvec *heap, int (*cmp)(const void *, const void *), size_t i, size_t length)
+{
+    for (;;)
+    {
+        size_t smallest = i, l = 2 * i + 1, r = 2 * i + 2;
+        if (l < length && DYNVEC_COMPARE(cmp, dynvec_get(heap, l), dynvec_get(heap, smallest)) < 0)
+            smallest = l;
+        if (r < length && DYNVEC_COMPARE(cmp, dynvec_get(heap, r), dynvec_get(heap, smallest)) < 0)
+            smallest = r;
+        if (smallest == i)
+            return;
+        swap(heap, i, smallest);
+        i = smallest;
+    }
+}
+
+// Seleciona os 'k' maiores elementos em um novo vetor
+dynvec *dynvec_top_k(dynvec *vec, size_t k, int (*cmp)(const void *, const void *))
+{
+    if (!vec || !cmp)
+        return NULL;
+    dynvec *heap = dynvec_create_with(vec->elem_size, vec->allocator);
+    if (heap && !dynvec_top_k_into(vec, k, cmp, heap))
+    {
+        dynvec_free(heap);
+        return NULL;
+    }
+    return heap;
+}
+
+// Seleciona os 'k' maiores elementos mantendo em 'heap' um heap de mínimo com no máximo 'k' elementos
+bool dynvec_top_k_into(dynvec *vec, size_t k, int (*cmp)(const void *, const void *), dynvec *heap)
+{
+    if (!vec || !cmp || !heap || heap == vec || heap->elem_size != vec->elem_size)
+        return false;
+    // O heap nunca passa de min(k, n) elementos: com a capacidade garantida, nenhum push realoca
+    heap->length = 0;
+    if (!dynvec_grow(heap, (k < vec->length) ? k : vec->length))
+        return false;
+
+    for (size_t i = 0; i < vec->length && k > 0; i++)
+    {
+        void *elem = (char *)vec->data + i * vec->elem_size;
+        if (heap->length < k)
+        {
+            // Heap ainda não está cheio: insere no final e sobe o elemento
+            dynvec_push(heap, elem);
+            for (size_t j = heap->length - 1; j > 0 && DYNVEC_COMPARE(cmp, dynvec_get(heap, j), dynvec_get(heap, (j - 1) / 2)) < 0; j = (j - 1) / 2)
+                swap(heap, j, (j - 1) / 2);
+        }
+        else if (DYNVEC_COMPARE(cmp, elem, heap->data) > 0)
+        {
+            // Elemento maior que o menor do heap: substitui a raiz
+            memcpy(heap->data, elem, vec->elem_size);
+            sift_down(heap, cmp, 0, heap->length);
+        }
+    }
+
+    // Ordena o heap: cada menor elemento vai para o final, deixando o vetor do maior para o menor
+    for (size_t end = heap->length; end > 1; end--)
+    {
+        swap(heap, 0, end - 1);
+        sift_down(heap, cmp, 0, end - 1);
+    }
+    return true;
+}
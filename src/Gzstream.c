@@ -0,0 +1,242 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <zlib.h>
+#include <Gzstream.h>
+
+// Bloco de bytes descomprimidos
+typedef struct Block
+{
+    char *data;  // Bytes descomprimidos (GZSTREAM_BLOCK_SIZE bytes reservados)
+    size_t size; // Quantidade de bytes válidos
+} Block;
+
+// Estrutura que representa a leitura de um arquivo gzip
+typedef struct Intgzstream
+{
+    int fd;           // Descritor do arquivo comprimido
+    pthread_t thread; // Thread que descomprime
+    char *input;      // Pedaço do arquivo comprimido sendo descomprimido (só a thread usa)
+    size_t prefix;    // Bytes já lidos do arquivo por quem abriu, guardados em 'input' para a primeira leitura
+    Block blocks[2];  // Blocos alternados: um é consumido enquanto o outro é preenchido
+    size_t head;      // Bloco sendo consumido (só quem lê usa)
+    size_t offset;    // Bytes já consumidos do bloco 'head' (só quem lê usa)
+
+    pthread_mutex_t lock;    // Protege os campos abaixo
+    pthread_cond_t ready;    // Sinaliza um bloco preenchido (ou o fim da descompressão)
+    pthread_cond_t consumed; // Sinaliza um bloco consumido (ou o pedido de parada)
+    int filled;              // Quantidade de blocos preenchidos e ainda não consumidos (0 a 2)
+    bool done;               // A thread terminou: não haverá mais blocos
+    int error;               // errno do erro que terminou a descompressão (0 se não houve)
+    bool stop;               // Pedido de parada (gzstream_close antes do fim)
+} gzstream;
+
+/*-------------------------------------------------------
+   Funções auxiliares
+-------------------------------------------------------*/
+
+// Função auxiliar: lê o próximo pedaço do arquivo comprimido. Retorna a quantidade lida (0 no fim) ou -1
+static ssize_t read_input(gzstream *gz)
+{
+    if (gz->prefix > 0)
+    {
+        ssize_t got = (ssize_t)gz->prefix;
+        gz->prefix = 0;
+        return got;
+    }
+    ssize_t got;
+    do
+        got = read(gz->fd, gz->input, GZSTREAM_INPUT_SIZE);
+    while (got < 0 && errno == EINTR);
+    return got;
+}
+
+// Função auxiliar: laço da thread, que preenche os blocos alternadamente até o fim do arquivo
+static void *inflate_loop(void *arg)
+{
+    gzstream *gz = (gzstream *)arg;
+    z_stream z = {0};
+    int error = (inflateInit2(&z, 15 + 32) == Z_OK) ? 0 : ENOMEM; // 15 + 32: detecta o cabeçalho gzip
+    bool input_end = false; // O arquivo comprimido terminou
+    bool member_end = true; // O último membro lido terminou (o arquivo pode acabar aqui)
+    bool finished = false;  // Não há mais bytes descomprimidos
+    size_t slot = 0;        // Próximo bloco a ser preenchido
+
+    while (!error && !finished)
+    {
+        // Espera o bloco 'slot' ser consumido
+        pthread_mutex_lock(&gz->lock);
+        while (gz->filled == 2 && !gz->stop)
+            pthread_cond_wait(&gz->consumed, &gz->lock);
+        bool stop = gz->stop;
+        pthread_mutex_unlock(&gz->lock);
+        if (stop)
+            break;
+
+        Block *block = &gz->blocks[slot];
+        z.next_out = (Bytef *)block->data;
+        z.avail_out = GZSTREAM_BLOCK_SIZE;
+        while (z.avail_out > 0 && !error)
+        {
+            if (z.avail_in == 0 && !input_end)
+            {
+                ssize_t got = read_input(gz);
+                if (got < 0)
+                {
+                    error = errno;
+                    break;
+                }
+                input_end = (got == 0);
+                z.next_in = (Bytef *)gz->input;
+                z.avail_in = (uInt)got;
+            }
+            if (z.avail_in == 0)
+            {
+                // Fim do arquivo no meio de um membro: o arquivo está truncado
+                if (!member_end)
+                    error = EIO;
+                finished = true;
+                break;
+            }
+
+            uInt before = z.avail_in;
+            int ret = inflate(&z, Z_NO_FLUSH);
+            if (ret == Z_STREAM_END)
+            {
+                // Fim de um membro: o próximo, se houver, começa com um novo cabeçalho
+                member_end = true;
+                inflateReset(&z);
+            }
+            else if (ret == Z_OK || ret == Z_BUF_ERROR)
+            {
+                if (z.avail_in != before)
+                    member_end = false;
+            }
+            else
+                error = (ret == Z_MEM_ERROR) ? ENOMEM : EIO;
+        }
+
+        block->size = GZSTREAM_BLOCK_SIZE - z.avail_out;
+        pthread_mutex_lock(&gz->lock);
+        if (block->size > 0)
+            gz->filled++;
+        gz->error = error;
+        gz->done = error || finished;
+        pthread_cond_signal(&gz->ready);
+        pthread_mutex_unlock(&gz->lock);
+        if (block->size > 0)
+            slot ^= 1;
+    }
+
+    inflateEnd(&z);
+    pthread_mutex_lock(&gz->lock);
+    gz->done = true;
+    pthread_cond_signal(&gz->ready);
+    pthread_mutex_unlock(&gz->lock);
+    return NULL;
+}
+
+/*-------------------------------------------------------
+   Funções da leitura de arquivos gzip
+-------------------------------------------------------*/
+
+// Verifica se o arquivo começa com a assinatura do gzip
+bool gzstream_detect(int fd)
+{
+    unsigned char magic[2];
+    return pread(fd, magic, sizeof(magic), 0) == (ssize_t)sizeof(magic) && magic[0] == 0x1f && magic[1] == 0x8b;
+}
+
+// Começa a descomprimir o arquivo em uma thread própria
+gzstream *gzstream_open(int fd, const void *prefix, size_t prefix_size)
+{
+    if (prefix_size > GZSTREAM_INPUT_SIZE)
+        return NULL;
+    gzstream *gz = calloc(1, sizeof(gzstream));
+    if (!gz)
+        return NULL;
+    gz->fd = fd;
+    gz->input = malloc(GZSTREAM_INPUT_SIZE);
+    gz->blocks[0].data = malloc(GZSTREAM_BLOCK_SIZE);
+    gz->blocks[1].data = malloc(GZSTREAM_BLOCK_SIZE);
+    if (gz->input && prefix_size > 0)
+    {
+        memcpy(gz->input, prefix, prefix_size);
+        gz->prefix = prefix_size;
+    }
+    pthread_mutex_init(&gz->lock, NULL);
+    pthread_cond_init(&gz->ready, NULL);
+    pthread_cond_init(&gz->consumed, NULL);
+    if (!gz->input || !gz->blocks[0].data || !gz->blocks[1].data ||
+        pthread_create(&gz->thread, NULL, inflate_loop, gz) != 0)
+    {
+        // Sem a thread, não há o que interromper: só a memória é liberada
+        gz->done = true;
+        gz->stop = true;
+        gzstream_close(gz);
+        return NULL;
+    }
+    return gz;
+}
+
+// Copia até 'size' bytes descomprimidos para 'buf'
+ssize_t gzstream_read(gzstream *gz, void *buf, size_t size)
+{
+    pthread_mutex_lock(&gz->lock);
+    while (gz->filled == 0 && !gz->done)
+        pthread_cond_wait(&gz->ready, &gz->lock);
+    if (gz->filled == 0)
+    {
+        int error = gz->error;
+        pthread_mutex_unlock(&gz->lock);
+        if (!error)
+            return 0;
+        errno = error;
+        return -1;
+    }
+    pthread_mutex_unlock(&gz->lock);
+
+    // O bloco 'head' está preenchido: a thread só escreve no outro
+    Block *block = &gz->blocks[gz->head];
+    size_t count = block->size - gz->offset;
+    if (count > size)
+        count = size;
+    memcpy(buf, block->data + gz->offset, count);
+    gz->offset += count;
+    if (gz->offset == block->size)
+    {
+        pthread_mutex_lock(&gz->lock);
+        gz->filled--;
+        pthread_cond_signal(&gz->consumed);
+        pthread_mutex_unlock(&gz->lock);
+        gz->head ^= 1;
+        gz->offset = 0;
+    }
+    return (ssize_t)count;
+}
+
+// Interrompe a descompressão e libera a memória
+void gzstream_close(gzstream *gz)
+{
+    if (!gz)
+        return;
+    pthread_mutex_lock(&gz->lock);
+    bool started = !gz->stop;
+    gz->stop = true;
+    pthread_cond_signal(&gz->consumed);
+    pthread_mutex_unlock(&gz->lock);
+    if (started)
+        pthread_join(gz->thread, NULL);
+
+    pthread_mutex_destroy(&gz->lock);
+    pthread_cond_destroy(&gz->ready);
+    pthread_cond_destroy(&gz->consumed);
+    free(gz->input);
+    free(gz->blocks[0].data);
+    free(gz->blocks[1].data);
+    free(gz);
+}
@@ -2,124 +2,1427 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
-#include <ctype.h>
 #include <GenericDynvec.h>
+#include <Arena.h>
+#include <Wordmap.h>
+#include <Tokenizer.h>
+#include <SpaceSaving.h>
+#include <External.h>
+#include <Wordindex.h>
+#include <Corpus.h>
+#include <Ngram.h>
+#include <Server.h>
+#include <Wordrank.h>
+#include <Stats.h>
 #include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
 
-#define MAX_WORD_LENGTH 50 // Capacidade máxima de uma palavra
+#define DEFAULT_MEM_BUDGET (64 * 1024 * 1024) // Orçamento de memória padrão do modo aproximado (64 MiB)
+#define DEFAULT_READERS 2                     // Threads de leitura padrão do modo corpus
+#define DEFAULT_SERVER_THREADS 4              // Threads de atendimento padrão do servidor
+#define DEFAULT_INTERVAL 1.0                  // Intervalo padrão (em segundos) entre os rankings do modo --follow
+#define MAX_INTERVAL (INT_MAX / 1000)         // Maior intervalo aceito (em segundos): em milissegundos, cabe no timeout do poll
 
 // Estrura auxiliar para contar as aparições de cada palavra
 typedef struct Word
 {
-    char *word;
+    const char *word; // Handle da palavra na arena
     size_t times;
 } word;
 
-// Função para comparar duas strings
-int string_comp(const void *key, const void *elem)
+// Handle de uma palavra guardada na arena
+typedef const char *word_handle;
+
+// Função para comparar duas strings (elementos do vetor são handles da arena)
+int string_comp(const word_handle *key, const word_handle *elem)
 {
-    const char *key_str = (const char *)key;
-    const char *elem_str = (const char *)elem;
-    return strcmp(key_str, elem_str);
+    return strcmp(*key, *elem);
 }
 
 // Função para comparar as aparições de duas estruturas word
-int word_times_comp(const void *key, const void *elem)
+// (compara em vez de subtrair, pois a diferença de dois size_t não cabe em um int)
+int word_times_comp(const word *key, const word *elem)
 {
-    return ((const word *)key)->times - ((const word *)elem)->times;
+    return (key->times > elem->times) - (key->times < elem->times);
 }
 
-int main()
+// Função para comparar as aparições de duas estruturas word, desempatando pela palavra,
+// para que o ranking seja sempre o mesmo
+int word_rank_comp(const word *key, const word *elem)
 {
-    int n;
-    if (scanf("%d", &n) != 1) // Lê quantas palavras o usuário quer e guarda na variável 'n'
+    int comp = word_times_comp(key, elem);
+    return comp ? comp : strcmp(key->word, elem->word);
+}
+
+// Vetores especializados: as funções de comparação são inlinadas na ordenação e na seleção
+DYNVEC_DEFINE(word_handle, handle_vec)
+DYNVEC_DEFINE(word, word_vec)
+DYNVEC_DEFINE_SORT(word, word_vec, word_rank_comp)
+
+// Seleção incremental das 'n' palavras mais usadas, para palavras que chegam uma a uma
+typedef struct TopAccumulator
+{
+    size_t n;        // Quantidade de palavras do ranking
+    word_vec *words; // Candidatas ao ranking
+    arena *store;    // Arena com as palavras das candidatas
+    size_t unique;   // Quantidade de palavras distintas recebidas
+} top_accumulator;
+
+// Reduz as candidatas às 'n' mais usadas, copiando só as suas palavras para uma nova arena
+static bool top_compact(top_accumulator *acc)
+{
+    word_vec *top = word_vec_top_k(acc->words, acc->n);
+    arena *store = arena_create();
+    bool ok = top && store;
+    for (size_t i = 0; ok && i < word_vec_length(top); i++)
+    {
+        top->data[i].word = arena_store(store, top->data[i].word, arena_len(top->data[i].word));
+        ok = top->data[i].word != NULL;
+    }
+    if (!ok)
+    {
+        word_vec_free(top);
+        arena_free(store);
+        return false;
+    }
+    word_vec_free(acc->words);
+    arena_free(acc->store);
+    acc->words = top;
+    acc->store = store;
+    return true;
+}
+
+// Recebe uma palavra com sua contagem final (usada como external_emit)
+static bool top_accumulate(const char *text, size_t len, size_t times, void *ctx)
+{
+    top_accumulator *acc = (top_accumulator *)ctx;
+    acc->unique++;
+    if (acc->n == 0)
+        return true;
+    word candidate = {arena_store(acc->store, text, len), times};
+    if (!candidate.word || !word_vec_push(acc->words, candidate))
+        return false;
+    // A memória fica proporcional a 'n': as candidatas são reduzidas quando passam de 4n
+    if (word_vec_length(acc->words) >= 4 * acc->n + 1024)
+        return top_compact(acc);
+    return true;
+}
+
+// Parte da entrada contada por uma thread
+typedef struct Shard
+{
+    const char *data; // Início da parte
+    size_t size;      // Tamanho da parte em bytes
+    wordmap *map;     // Tabela local da thread
+    bool ok;          // Indica se a contagem terminou sem erros
+} shard;
+
+// Conta as palavras de uma parte da entrada em uma tabela local
+static void *count_shard(void *arg)
+{
+    shard *part = (shard *)arg;
+    tokenizer *tk = tokenizer_open_buffer(part->data, part->size);
+    token tok;
+
+    part->map = wordmap_create();
+    part->ok = (tk && part->map);
+    while (part->ok && tokenizer_next(tk, &tok))
+        part->ok = wordmap_add(part->map, tok.ptr, tok.len, 1);
+
+    tokenizer_close(tk);
+    STATS_FLUSH();
+    return NULL;
+}
+
+// Divide 'data' em 'threads' partes, ajustadas para não cortar palavras, conta cada parte
+// em uma thread e junta as tabelas locais em uma só. Retorna NULL em caso de erro.
+static wordmap *count_words_parallel(const char *data, size_t size, int threads)
+{
+    shard *parts = calloc(threads, sizeof(shard));
+    pthread_t *ids = malloc(threads * sizeof(pthread_t));
+    if (!parts || !ids)
+    {
+        free(parts);
+        free(ids);
+        return NULL;
+    }
+
+    size_t start = 0;
+    for (int i = 0; i < threads; i++)
+    {
+        size_t end = (i == threads - 1) ? size : tokenizer_boundary(data, size, size / threads * (i + 1));
+        if (end < start)
+            end = start;
+        parts[i].data = data + start;
+        parts[i].size = end - start;
+        start = end;
+    }
+
+    int started = 0;
+    for (; started < threads; started++)
+    {
+        if (pthread_create(&ids[started], NULL, count_shard, &parts[started]) != 0)
+            break;
+    }
+    // Caso não seja possível criar todas as threads, as partes restantes são contadas nesta
+    for (int i = started; i < threads; i++)
+        count_shard(&parts[i]);
+    for (int i = 0; i < started; i++)
+        pthread_join(ids[i], NULL);
+
+    // Junta as tabelas locais na tabela da primeira parte
+    wordmap *map = parts[0].map;
+    bool ok = parts[0].ok;
+    for (int i = 1; i < threads; i++)
+    {
+        ok = ok && parts[i].ok && wordmap_merge(map, parts[i].map);
+        wordmap_free(parts[i].map);
+    }
+    if (!ok)
+    {
+        wordmap_free(map);
+        map = NULL;
+    }
+
+    free(parts);
+    free(ids);
+    return map;
+}
+
+// Conta as palavras da entrada em uma tabela; com mais de uma thread, a entrada precisa estar
+// mapeada em memória para ser dividida. Retorna NULL em caso de erro.
+static wordmap *count_words(tokenizer *tk, int threads)
+{
+    size_t size;
+    const char *data = tokenizer_buffer(tk, &size);
+
+    // Com várias threads, cada uma conta uma parte do arquivo mapeado em sua própria tabela
+    if (threads > 1 && data)
+        return count_words_parallel(data, size, threads);
+
+    // Conta cada palavra diretamente na tabela, sem precisar ordenar todas as palavras lidas.
+    // A palavra só é copiada quando aparece pela primeira vez.
+    wordmap *map = wordmap_create();
+    token tok;
+    while (map && tokenizer_next(tk, &tok))
+    {
+        if (!wordmap_add(map, tok.ptr, tok.len, 1))
+        {
+            wordmap_free(map);
+            return NULL;
+        }
+    }
+    return map;
+}
+
+// Lê um tamanho em bytes com sufixo opcional (K, M ou G). Retorna false se for inválido
+static bool parse_size(const char *text, size_t *size)
+{
+    char *end;
+    errno = 0;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (errno || end == text)
+        return false;
+    switch (*end)
+    {
+    case 'G':
+    case 'g':
+        value *= 1024;
+        /* fall through */
+    case 'M':
+    case 'm':
+        value *= 1024;
+        /* fall through */
+    case 'K':
+    case 'k':
+        value *= 1024;
+        end++;
+        break;
+    }
+    *size = (size_t)value;
+    return *end == '\0' && value > 0;
+}
+
+// Abre a entrada: "-" é a entrada padrão (lida em blocos); qualquer outro caminho é mapeado em memória
+static tokenizer *open_input(const char *path)
+{
+    if (strcmp(path, "-") == 0)
+        return tokenizer_open_fd(STDIN_FILENO);
+    return tokenizer_open(path);
+}
+
+// Escreve no console as 'n' palavras com maior estimativa do modo aproximado. Retorna false se faltar memória
+static bool print_approx(spacesaving *ss, size_t n)
+{
+    dynvec *top = spacesaving_top(ss, n);
+    if (!top)
+        return false;
+    for (size_t i = 0; i < dynvec_length(top); i++)
+    {
+        spacesaving_item *item = (spacesaving_item *)dynvec_get(top, i);
+        printf("%zuº: \"%s\", %zu aparições (erro máximo: %zu)\n", i + 1, item->word, item->count, item->error);
+    }
+    dynvec_free(top);
+    fflush(stdout);
+    return true;
+}
+
+// Modo aproximado: conta as palavras em memória fixa (Space-Saving), emitindo o ranking a cada
+// 'every' palavras (se 'every' > 0) e no final da entrada
+static int run_approx(tokenizer *tk, size_t n, size_t budget, bool count_min, size_t every)
+{
+    spacesaving *ss = spacesaving_create(budget, count_min);
+    if (!ss)
+    {
+        perror("Error counting words");
         return -1;
+    }
 
-    char book_path[200]; // Guarda o caminho do livro à ser lido
-    if (scanf("%199s", book_path) != 1)
+    token tok;
+    STATS_PHASE_BEGIN(STATS_TOKENIZE);
+    while (tokenizer_next(tk, &tok))
+    {
+        if (!spacesaving_add(ss, tok.ptr, tok.len))
+        {
+            perror("Error counting words");
+            spacesaving_free(ss);
+            return -1;
+        }
+        if (every > 0 && spacesaving_total(ss) % every == 0)
+        {
+            printf("--- %zu palavras ---\n", spacesaving_total(ss));
+            if (!print_approx(ss, n))
+            {
+                perror("Error counting words");
+                spacesaving_free(ss);
+                return -1;
+            }
+        }
+    }
+
+    STATS_PHASE_END(STATS_TOKENIZE);
+
+    bool read_error = tokenizer_error(tk);
+    if (!read_error)
+    {
+        STATS_PHASE_BEGIN(STATS_OUTPUT);
+        if (every > 0)
+            printf("--- %zu palavras (fim) ---\n", spacesaving_total(ss));
+        bool printed = print_approx(ss, n);
+        STATS_PHASE_END(STATS_OUTPUT);
+        if (!printed)
+        {
+            perror("Error counting words");
+            spacesaving_free(ss);
+            return -1;
+        }
+    }
+    else
+        perror("Error reading file");
+
+    spacesaving_free(ss);
+    return read_error ? -1 : 0;
+}
+
+// Modo de sequências: conta as sequências de 'k' palavras consecutivas e escreve as 'n' mais frequentes
+static int run_ngram(tokenizer *tk, size_t n, size_t k)
+{
+    STATS_PHASE_BEGIN(STATS_TOKENIZE);
+    ngrammap *nm = ngrammap_create(k);
+    bool ok = nm != NULL;
+    token tok;
+    while (ok && tokenizer_next(tk, &tok))
+        ok = ngrammap_add(nm, tok.ptr, tok.len);
+    STATS_PHASE_END(STATS_TOKENIZE);
+
+    if (!ok || tokenizer_error(tk))
+    {
+        perror(ok ? "Error reading file" : "Error counting words");
+        ngrammap_free(nm);
         return -1;
-    getchar(); // Consome o '\n' deixado no buffer
+    }
+    STATS_ADD(STATS_UNIQUE_WORDS, wordmap_length(ngrammap_words(nm)));
 
-    dynvec *vec_input = dynvec_create(sizeof(char) * MAX_WORD_LENGTH); // Vetor para guardar todas as palavras lidas no arquivo
+    STATS_PHASE_BEGIN(STATS_SELECT);
+    dynvec *top = ngrammap_top(nm, n);
+    STATS_PHASE_END(STATS_SELECT);
 
-    FILE *file = fopen(book_path, "r"); // Variável para guardar o arquivo.
-    if (!file)
+    // O texto de cada sequência só é montado aqui, para as 'n' escritas
+    STATS_PHASE_BEGIN(STATS_OUTPUT);
+    for (size_t i = 0; top && i < dynvec_length(top); i++)
     {
-        perror("Error opening file"); // Emite um erro caso não seja possível ler o arquivo
+        ngram_entry *entry = (ngram_entry *)dynvec_get(top, i);
+        printf("%zuº: \"", i + 1);
+        for (size_t j = 0; j < ngram_length(entry); j++)
+            printf("%s%s", j ? " " : "", ngram_word(entry, j));
+        printf("\", %zu aparições\n", entry->times);
+    }
+    STATS_PHASE_END(STATS_OUTPUT);
+
+    dynvec_free(top);
+    ngrammap_free(nm);
+    return top ? 0 : -1;
+}
+
+// Estado do modo --follow: a tabela e o ranking ficam em memória enquanto o arquivo cresce
+typedef struct Follower
+{
+    wordmap *map;    // Tabela com as aparições de cada palavra
+    wordrank *rank;  // Ranking incremental das 'n' palavras mais usadas
+    dynvec *top;     // Último ranking emitido (reaproveitado a cada emissão)
+    size_t n;        // Quantidade de palavras do ranking
+    size_t words;    // Quantidade total de palavras contadas
+    char *buffer;    // Bytes lidos que ainda não foram contados
+    size_t capacity; // Tamanho do buffer
+    size_t carry;    // Bytes no início do buffer com a última palavra, que pode continuar na próxima leitura
+} follower;
+
+// Recomeça a contagem do zero (arquivo truncado). Retorna false se faltar memória
+static bool follow_reset(follower *f)
+{
+    wordrank_free(f->rank);
+    wordmap_free(f->map);
+    f->map = wordmap_create();
+    f->rank = f->map ? wordrank_create(f->map, f->n, false) : NULL;
+    f->words = 0;
+    f->carry = 0;
+    return f->rank != NULL;
+}
+
+// Conta as palavras completas dos 'length' bytes do buffer, guardando a última palavra no início
+// do buffer para a próxima leitura (com 'final', ela também é contada). Retorna false se faltar memória
+static bool follow_count(follower *f, size_t length, bool final)
+{
+    size_t end = final ? length : tokenizer_word_start(f->buffer, length);
+    tokenizer *tk = tokenizer_open_buffer(f->buffer, end);
+    token tok;
+    bool ok = tk != NULL;
+    while (ok && tokenizer_next(tk, &tok))
+    {
+        // A contagem é atualizada no lugar e só a palavra alterada é reposicionada no ranking
+        wordmap_entry *entry = wordmap_intern(f->map, tok.ptr, tok.len);
+        ok = entry && wordrank_update(f->rank, entry);
+        f->words++;
+    }
+    tokenizer_close(tk);
+    memmove(f->buffer, f->buffer + end, length - end);
+    f->carry = length - end;
+    return ok;
+}
+
+// Lê e conta os bytes novos do arquivo, até o seu fim atual. Retorna false em caso de erro
+static bool follow_read(follower *f, int fd)
+{
+    for (;;)
+    {
+        // Uma palavra maior que o buffer inteiro: o buffer cresce para que ela continue
+        if (f->carry == f->capacity)
+        {
+            char *temp = realloc(f->buffer, f->capacity * 2);
+            if (!temp)
+                return false;
+            f->buffer = temp;
+            f->capacity *= 2;
+        }
+        ssize_t count = read(fd, f->buffer + f->carry, f->capacity - f->carry);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            return count == 0;
+        STATS_ADD(STATS_BYTES_READ, count);
+        if (!follow_count(f, f->carry + (size_t)count, false))
+            return false;
+    }
+}
+
+// Escreve no console o ranking do modo --follow
+static bool print_follow(follower *f, bool end)
+{
+    if (!wordrank_top_into(f->rank, f->top))
+        return false;
+    printf("--- %zu palavras%s ---\n", f->words, end ? " (fim)" : "");
+    for (size_t i = 0; i < dynvec_length(f->top); i++)
+    {
+        wordmap_entry *entry = (wordmap_entry *)dynvec_get(f->top, i);
+        printf("%zuº: \"%s\", %zu aparições\n", i + 1, entry->word, entry->times);
+    }
+    fflush(stdout);
+    return true;
+}
+
+// Tempo atual em milissegundos (relógio monotônico)
+static long long now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+// Modo --follow: conta o arquivo e continua contando os bytes acrescentados a ele (avisados pelo
+// inotify), emitindo o ranking no máximo a cada 'interval' milissegundos quando ele muda.
+// Termina quando o arquivo é apagado ou renomeado
+static int run_follow(const char *path, size_t n, long long interval)
+{
+    follower f = {.n = n, .capacity = TOKENIZER_BLOCK_SIZE};
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    int notify = inotify_init1(IN_CLOEXEC);
+    if (fd < 0 || notify < 0 || inotify_add_watch(notify, path, IN_MODIFY | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF) < 0)
+    {
+        perror("Error opening file");
+        if (fd >= 0)
+            close(fd);
+        if (notify >= 0)
+            close(notify);
         return -1;
     }
 
-    char ch;                            // Guarda cada letra lida no livro
-    int len = 0;                        // Guarda o tamanho de cada palavra lida
-    char current_word[MAX_WORD_LENGTH]; // Guarda a palavra atual
+    f.buffer = malloc(f.capacity);
+    f.top = dynvec_create(sizeof(wordmap_entry));
+    bool ok = f.buffer && f.top && follow_reset(&f) && follow_read(&f, fd) && print_follow(&f, false);
+    long long next_print = now_ms() + interval;
+    bool changed = false; // Há palavras contadas depois do último ranking
+    bool gone = false;    // O arquivo foi apagado ou renomeado
+
+    while (ok && !gone)
+    {
+        // Sem mudanças, espera o próximo evento; com mudanças, no máximo até o próximo ranking
+        long long wait = changed ? next_print - now_ms() : -1;
+        struct pollfd pfd = {notify, POLLIN, 0};
+        if (wait > INT_MAX)
+            wait = INT_MAX;
+        int ready = poll(&pfd, 1, (changed && wait < 0) ? 0 : (int)wait);
+        if (ready < 0 && errno != EINTR)
+            ok = false;
+        if (ready > 0)
+        {
+            // Só importa que o arquivo mudou (ou sumiu): os eventos acumulados são descartados
+            char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+            ssize_t length = read(notify, events, sizeof(events));
+            for (ssize_t i = 0; i < length; i += sizeof(struct inotify_event) + ((struct inotify_event *)(events + i))->len)
+            {
+                if (((struct inotify_event *)(events + i))->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED))
+                    gone = true;
+            }
+
+            // Como o arquivo continua aberto, apagá-lo não gera IN_DELETE_SELF, só IN_ATTRIB (sem links).
+            // Arquivo menor que a posição lida: foi truncado e é contado de novo
+            struct stat st;
+            bool stat_ok = fstat(fd, &st) == 0;
+            if (stat_ok && st.st_nlink == 0)
+                gone = true;
+            if (stat_ok && st.st_size < lseek(fd, 0, SEEK_CUR))
+            {
+                printf("--- arquivo truncado ---\n");
+                ok = follow_reset(&f) && lseek(fd, 0, SEEK_SET) == 0;
+            }
+            size_t before = f.words;
+            ok = ok && follow_read(&f, fd);
+            changed = changed || f.words != before;
+        }
+        if (ok && changed && now_ms() >= next_print)
+        {
+            ok = print_follow(&f, false);
+            changed = false;
+            next_print = now_ms() + interval;
+        }
+    }
+
+    // O arquivo não vai mais crescer: a última palavra guardada está completa
+    ok = ok && follow_count(&f, f.carry, true) && print_follow(&f, true);
+    if (!ok)
+        perror("Error following file");
+    wordrank_free(f.rank);
+    wordmap_free(f.map);
+    dynvec_free(f.top);
+    free(f.buffer);
+    close(notify);
+    close(fd);
+    return ok ? 0 : -1;
+}
+
+// Escreve o ranking de uma janela ou capítulo em uma única linha, depois do rótulo já escrito
+static void print_row(dynvec *top)
+{
+    for (size_t i = 0; i < dynvec_length(top); i++)
+    {
+        wordmap_entry *entry = (wordmap_entry *)dynvec_get(top, i);
+        printf("%s\"%s\" %zu", i ? ", " : ": ", entry->word, entry->times);
+    }
+    printf("\n");
+}
+
+// Modo de janelas: emite uma linha com o ranking das 'n' palavras mais usadas em cada janela de
+// 'window' palavras consecutivas, avançando 'step' palavras por vez. A janela é atualizada com
+// deltas (a palavra que entra soma uma aparição, a que sai desconta uma) e o ranking é mantido
+// incrementalmente, sem recontar nem ordenar o vocabulário a cada janela
+static int run_window(tokenizer *tk, size_t n, size_t window, size_t step)
+{
+    wordmap *map = wordmap_create();
+    wordrank *rank = map ? wordrank_create(map, n, true) : NULL;
+    size_t *ring = malloc(window * sizeof(size_t)); // Índices (na tabela) das palavras da janela, em ordem de leitura
+    dynvec *top = dynvec_create(sizeof(wordmap_entry)); // Ranking da janela, reaproveitado: as linhas não alocam memória
+    bool ok = rank && ring && top;
+
+    token tok;
+    size_t read = 0;    // Quantidade de palavras lidas
+    size_t pending = 0; // Palavras lidas depois da última linha emitida
+    size_t rows = 0;    // Quantidade de linhas emitidas
+    STATS_PHASE_BEGIN(STATS_TOKENIZE);
+    while (ok && tokenizer_next(tk, &tok))
+    {
+        wordmap_entry *entry = wordmap_intern(map, tok.ptr, tok.len);
+        ok = entry && wordrank_update(rank, entry);
+        if (!ok)
+            break;
+        size_t slot = read % window;
+        size_t index = wordmap_index(map, entry);
+        if (read >= window)
+        {
+            // A palavra mais antiga sai da janela
+            wordmap_entry *old = wordmap_at(map, ring[slot]);
+            old->times--;
+            ok = wordrank_update(rank, old);
+        }
+        ring[slot] = index;
+        read++;
+        pending++;
+
+        if (ok && read >= window && (read - window) % step == 0)
+        {
+            ok = wordrank_top_into(rank, top);
+            if (ok)
+            {
+                printf("janela %zu (palavras %zu a %zu)", ++rows, read - window + 1, read);
+                print_row(top);
+            }
+            pending = 0;
+        }
+    }
+    STATS_PHASE_END(STATS_TOKENIZE);
 
-    while ((ch = fgetc(file)) != EOF) // Lê as letras e guarda em 'ch' até o fim do arquivo
+    // As últimas palavras, que não completaram um passo, fecham uma última janela
+    if (ok && pending > 0)
     {
-        // Insere em "current_word" 'ch', caso seja uma letra normal ou uma letra acentuada
-        if (isalpha(ch) || (unsigned)ch >= 128)
+        ok = wordrank_top_into(rank, top);
+        if (ok)
         {
-            current_word[len++] = ch;
+            printf("janela %zu (palavras %zu a %zu)", ++rows, (read > window) ? read - window + 1 : 1, read);
+            print_row(top);
         }
-        // Caso exista uma palavra, insere o terminador nulo, a coloca no vetor "vec_input" e reinicia o "len"
-        else if (len > 0)
+    }
+
+    bool read_error = tokenizer_error(tk);
+    if (!ok || read_error)
+        perror(read_error ? "Error reading file" : "Error counting words");
+    free(ring);
+    dynvec_free(top);
+    wordrank_free(rank);
+    wordmap_free(map);
+    return (ok && !read_error) ? 0 : -1;
+}
+
+// Retorna o tamanho da linha sem os espaços e o '\r' do final
+static size_t trim_line(const char *line, size_t len)
+{
+    while (len > 0 && (line[len - 1] == '\r' || line[len - 1] == ' ' || line[len - 1] == '\t'))
+        len--;
+    return len;
+}
+
+// Verifica se a linha (sem espaços no final) é o título de um capítulo: só um número romano (ex.: "XII")
+static bool is_chapter_heading(const char *line, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        if (!strchr("IVXLC", line[i]))
+            return false;
+    }
+    return len > 0;
+}
+
+// Conta as palavras de um capítulo e emite o seu ranking. Retorna false em caso de erro
+static bool count_chapter(const char *data, size_t size, const char *title, size_t title_len, size_t n)
+{
+    tokenizer *tk = tokenizer_open_buffer(data, size);
+    wordmap *map = tk ? count_words(tk, 1) : NULL;
+    tokenizer_close(tk);
+    dynvec *top = map ? dynvec_top_k(wordmap_entries(map), n, wordmap_rank_comp) : NULL;
+    if (top)
+    {
+        size_t words = 0;
+        for (size_t i = 0; i < dynvec_length(wordmap_entries(map)); i++)
+            words += ((wordmap_entry *)dynvec_get(wordmap_entries(map), i))->times;
+        // O texto antes do primeiro título só é emitido se tiver palavras
+        if (title)
+            printf("capítulo %.*s (%zu palavras)", (int)title_len, title, words);
+        else if (words > 0)
+            printf("início (%zu palavras)", words);
+        if (title || words > 0)
+            print_row(top);
+    }
+    dynvec_free(top);
+    wordmap_free(map);
+    return top != NULL;
+}
+
+// Modo de capítulos: divide o livro nos títulos de capítulo (linhas com só um número romano) e
+// emite uma linha com o ranking de cada capítulo. O texto antes do primeiro título é o "início"
+static int run_chapters(tokenizer *tk, size_t n)
+{
+    size_t size;
+    const char *data = tokenizer_buffer(tk, &size);
+    if (!data)
+    {
+        fprintf(stderr, "--chapters precisa de um arquivo sem compressão (não lê a entrada padrão nem arquivos gzip)\n");
+        return -1;
+    }
+
+    const char *start = data;  // Início do capítulo atual
+    const char *title = NULL;  // Título do capítulo atual (NULL antes do primeiro)
+    size_t title_len = 0;
+    bool ok = true;
+    for (const char *line = data; ok && line < data + size;)
+    {
+        const char *end = memchr(line, '\n', data + size - line);
+        const char *next = end ? end + 1 : data + size;
+        size_t len = trim_line(line, (end ? end : data + size) - line);
+        if (is_chapter_heading(line, len))
         {
-            current_word[len] = '\0';
-            dynvec_push(vec_input, current_word);
-            len = 0;
+            ok = count_chapter(start, line - start, title, title_len, n);
+            title = line;
+            title_len = len;
+            start = next;
         }
+        line = next;
+    }
+    ok = ok && count_chapter(start, data + size - start, title, title_len, n);
+    if (!ok)
+        perror("Error counting words");
+    return ok ? 0 : -1;
+}
+
+// Comando "build-index": conta as palavras do livro e grava o índice binário com o vocabulário
+static int run_build_index(int argc, char *argv[])
+{
+    int threads = 1;
+    const char *paths[2] = {NULL}; // Livro e índice
+    int path_count = 0;
+
+    for (int i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc && (threads = atoi(argv[i + 1])) > 0)
+            i++;
+        else if (strcmp(argv[i], "--fold") == 0)
+            tokenizer_set_fold(true);
+        else if ((argv[i][0] != '-' || strcmp(argv[i], "-") == 0) && path_count < 2)
+            paths[path_count++] = argv[i];
+        else
+            path_count = 3;
+    }
+    if (path_count != 2)
+    {
+        fprintf(stderr, "Uso: %s build-index [--threads N] [--fold] <livro> <índice>\n", argv[0]);
+        return -1;
+    }
+
+    tokenizer *tk = open_input(paths[0]);
+    if (!tk)
+    {
+        perror("Error opening file");
+        return -1;
+    }
+    wordmap *map = count_words(tk, threads);
+    bool read_error = tokenizer_error(tk);
+    tokenizer_close(tk);
+    if (!map || read_error)
+    {
+        perror("Error counting words");
+        wordmap_free(map);
+        return -1;
+    }
+
+    bool ok = wordindex_write(paths[1], map);
+    if (!ok)
+        perror("Error writing index");
+    wordmap_free(map);
+    return ok ? 0 : -1;
+}
+
+// Comando "query": abre o índice e escreve as 'n' palavras mais usadas
+// ou as aparições das palavras passadas com --word, sem ler o livro de novo
+static int run_query(int argc, char *argv[])
+{
+    const char *index_path = NULL;
+    const char *n_text = NULL;
+    int words = 0;     // Quantidade de --word
+    bool fold = false; // Normaliza as palavras procuradas, para um índice criado com --fold
+
+    for (int i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--word") == 0 && i + 1 < argc)
+            words++, i++;
+        else if (strcmp(argv[i], "--fold") == 0)
+            fold = true;
+        else if (argv[i][0] != '-' && !index_path)
+            index_path = argv[i];
+        else if (argv[i][0] != '-' && !n_text)
+            n_text = argv[i];
+        else
+            index_path = NULL, i = argc;
+    }
+    if (!index_path || (words > 0) == (n_text != NULL))
+    {
+        fprintf(stderr, "Uso: %s query <índice> <n>\n       %s query <índice> [--fold] --word PALAVRA [--word PALAVRA...]\n", argv[0], argv[0]);
+        return -1;
     }
 
-    fclose(file); // Fecha o arquivo
+    wordindex *ix = wordindex_open(index_path);
+    if (!ix)
+    {
+        perror("Error opening index");
+        return -1;
+    }
 
-    // Caso haja palavras no vetor, ordenas elas utilizando quicksort_three_way
-    if (dynvec_length(vec_input) > 0)
+    if (n_text)
     {
-        quicksort_dynvec_three_way(vec_input, string_comp, 0, dynvec_length(vec_input) - 1);
+        // O ranking já está gravado em ordem: basta percorrer as 'n' primeiras posições
+        char *end;
+        errno = 0;
+        unsigned long n = strtoul(n_text, &end, 10);
+        if (errno || end == n_text || *end != '\0' || n_text[0] == '-')
+        {
+            fprintf(stderr, "n inválido: %s\n", n_text);
+            wordindex_close(ix);
+            return -1;
+        }
+        size_t times;
+        for (size_t i = 0; i < n && i < wordindex_length(ix); i++)
+        {
+            const char *word = wordindex_word(ix, i, &times);
+            if (!word)
+            {
+                // A posição da palavra fica fora da seção de palavras (verificada só quando é lida)
+                fprintf(stderr, "%s: índice corrompido\n", index_path);
+                wordindex_close(ix);
+                return -1;
+            }
+            printf("%zuº: \"%s\", %zu aparições\n", i + 1, word, times);
+        }
     }
     else
     {
-        perror("Error reading file");
+        for (int i = 2; i < argc; i++)
+        {
+            if (strcmp(argv[i], "--word") != 0)
+                continue;
+            const char *word = argv[++i];
+            size_t count = 0;
+            if (fold)
+            {
+                // A palavra passa pelo mesmo tokenizador que normalizou o livro
+                tokenizer_set_fold(true);
+                tokenizer *tk = tokenizer_open_buffer(word, strlen(word));
+                token tok;
+                if (tk && tokenizer_next(tk, &tok))
+                    count = wordindex_count(ix, tok.ptr, tok.len);
+                tokenizer_close(tk);
+            }
+            else
+                count = wordindex_count(ix, word, strlen(word));
+            printf("\"%s\", %zu aparições\n", word, count);
+        }
+    }
+
+    wordindex_close(ix);
+    return 0;
+}
+
+// Comando "serve": carrega os livros uma única vez e atende pedidos em um socket Unix
+static int run_serve(int argc, char *argv[])
+{
+    const char *socket_path = SERVER_DEFAULT_SOCKET;
+    int threads = DEFAULT_SERVER_THREADS;
+    bool fold = false;
+    const char *paths[argc];
+    int path_count = 0;
+
+    for (int i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc)
+            socket_path = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc && (threads = atoi(argv[i + 1])) > 0)
+            i++;
+        else if (strcmp(argv[i], "--fold") == 0)
+            fold = true;
+        else if (argv[i][0] != '-')
+            paths[path_count++] = argv[i];
+        else
+            path_count = 0, i = argc;
+    }
+    if (path_count == 0)
+    {
+        fprintf(stderr, "Uso: %s serve [--socket CAMINHO] [--threads N] [--fold] <livro>...\n", argv[0]);
+        return -1;
+    }
+
+    tokenizer_set_fold(fold);
+    if (!server_run(socket_path, paths, path_count, threads, fold))
+    {
+        perror("Error running server");
         return -1;
     }
+    return 0;
+}
+
+// Verifica se o caminho é um diretório
+static bool is_directory(const char *path)
+{
+    struct stat st;
+    return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+// Acrescenta a 'paths' os arquivos do diretório 'dir' (sem entrar em subdiretórios nem arquivos
+// ocultos), em ordem alfabética. Os caminhos são guardados em 'store'. Retorna false em caso de erro
+static bool add_directory(dynvec *paths, arena *store, const char *dir)
+{
+    DIR *handle = opendir(dir);
+    if (!handle)
+        return false;
+
+    size_t first = dynvec_length(paths);
+    size_t dir_len = strlen(dir);
+    bool ok = true;
+    struct dirent *entry;
+    while (ok && (entry = readdir(handle)) != NULL)
+    {
+        if (entry->d_name[0] == '.')
+            continue;
+        size_t name_len = strlen(entry->d_name);
+        char *full = malloc(dir_len + name_len + 2);
+        ok = full != NULL;
+        if (!ok)
+            break;
+        snprintf(full, dir_len + name_len + 2, "%s/%s", dir, entry->d_name);
+
+        struct stat st;
+        if (stat(full, &st) == 0 && S_ISREG(st.st_mode))
+        {
+            const char *path = arena_store(store, full, dir_len + name_len + 1);
+            ok = path && dynvec_push(paths, &path);
+        }
+        free(full);
+    }
+    closedir(handle);
+
+    // readdir não garante nenhuma ordem: ordena para que a saída seja sempre a mesma
+    if (ok)
+        multikey_quicksort((const char **)dynvec_get(paths, first), dynvec_length(paths) - first);
+    return ok;
+}
+
+// Escreve no console um ranking de entradas da tabela (wordmap_entry)
+static void print_entries(dynvec *top)
+{
+    for (size_t i = 0; top && i < dynvec_length(top); i++)
+    {
+        wordmap_entry *entry = (wordmap_entry *)dynvec_get(top, i);
+        printf("%zuº: \"%s\", %zu aparições\n", i + 1, entry->word, entry->times);
+    }
+}
 
-    dynvec *vec_sorted = dynvec_create(sizeof(word)); // Vetor auxiliar para guardar as palavras com sua quantidade de aparições
-    word temp_word;
-    temp_word.times = 1; // Iniciliza em 1, pois cada palavra aparece pelo menos 1 vez
+// Modo corpus: conta vários documentos (arquivos ou diretórios) em um pipeline de leitura e
+// contagem, escrevendo o ranking de cada documento e o ranking global
+static int run_corpus(size_t n, const char **inputs, int input_count, int readers, int workers)
+{
+    dynvec *paths = dynvec_create(sizeof(char *));
+    arena *store = arena_create();
+    bool ok = paths && store;
+    for (int i = 0; ok && i < input_count; i++)
+    {
+        if (is_directory(inputs[i]))
+        {
+            ok = add_directory(paths, store, inputs[i]);
+            if (!ok)
+                fprintf(stderr, "Error reading directory %s: %s\n", inputs[i], strerror(errno));
+        }
+        else
+            ok = dynvec_push(paths, &inputs[i]);
+    }
 
-    // Copia os elementos de "vec_input" para "vec_sorted", contando quantas aparições tem cada palavra
-    for (size_t i = 0; i < dynvec_length(vec_input); i++)
+    // A leitura e a contagem acontecem ao mesmo tempo no pipeline: o tempo das duas fica em "tokenize"
+    STATS_PHASE_BEGIN(STATS_TOKENIZE);
+    corpus *c = ok ? corpus_count((const char **)dynvec_get(paths, 0), dynvec_length(paths), n, readers, workers) : NULL;
+    STATS_PHASE_END(STATS_TOKENIZE);
+    if (!c)
     {
-        char *atual = (char *)dynvec_get(vec_input, i);
+        perror("Error counting words");
+        dynvec_free(paths);
+        arena_free(store);
+        return -1;
+    }
 
-        // Caso a palavra atual e a seguinte sejam iguais, incrementa a sua aparição
-        if (i + 1 != dynvec_length(vec_input) && string_comp(atual, dynvec_get(vec_input, i + 1)) == 0)
+    // Rankings dos documentos, na ordem em que foram passados
+    STATS_PHASE_BEGIN(STATS_OUTPUT);
+    size_t words = 0, failed = 0;
+    for (size_t i = 0; i < corpus_length(c); i++)
+    {
+        corpus_document *doc = corpus_get(c, i);
+        if (!doc->ok)
         {
-            temp_word.times++;
+            fprintf(stderr, "Error reading %s: %s\n", doc->path, strerror(doc->error));
+            failed++;
+            continue;
         }
-        // Caso o contrário, guarda ela no vetor e reinicia as aparições para a próxima
+        printf("=== %s: %zu palavras, %zu distintas ===\n", doc->path, doc->words, doc->unique);
+        print_entries(doc->top);
+        words += doc->words;
+    }
+
+    STATS_PHASE_END(STATS_OUTPUT);
+
+    // Ranking global
+    wordmap *total = corpus_total(c);
+    STATS_ADD(STATS_UNIQUE_WORDS, wordmap_length(total));
+    STATS_PHASE_BEGIN(STATS_SELECT);
+    dynvec *top = dynvec_top_k(wordmap_entries(total), n, wordmap_rank_comp);
+    STATS_PHASE_END(STATS_SELECT);
+    STATS_PHASE_BEGIN(STATS_OUTPUT);
+    printf("=== Total: %zu documentos, %zu palavras, %zu distintas ===\n",
+           corpus_length(c) - failed, words, wordmap_length(total));
+    print_entries(top);
+    STATS_PHASE_END(STATS_OUTPUT);
+
+    dynvec_free(top);
+    corpus_free(c);
+    dynvec_free(paths);
+    arena_free(store);
+    return (failed > 0 || !top) ? -1 : 0;
+}
+
+// Escreve as estatísticas na saída de erro ao terminar o programa (registrada com atexit)
+static void print_stats(void)
+{
+    stats_print_json(stderr);
+}
+
+// Motores de contagem disponíveis
+typedef enum Engine
+{
+    ENGINE_HASH, // Conta as palavras em uma tabela hash (padrão)
+    ENGINE_SORT  // Ordena todas as palavras lidas e conta as repetições consecutivas
+} engine;
+
+// Escreve no console como utilizar o programa
+static void usage(const char *program)
+{
+    fprintf(stderr,
+            "Uso: %s [opções] [n] [livro...]\n"
+            "       %s build-index [--threads N] [--fold] <livro> <índice>\n"
+            "       %s query <índice> <n> | [--fold] --word PALAVRA...\n"
+            "       %s serve [--socket CAMINHO] [--threads N] [--fold] <livro>...\n"
+            "  Sem 'n' e 'livro', os dois são lidos da entrada padrão. O livro \"-\" é a entrada padrão.\n"
+            "  Com vários livros ou um diretório, mostra o ranking de cada livro e o ranking global.\n"
+            "  --engine=hash|sort    motor de contagem (padrão: hash)\n"
+            "  --threads N           conta o arquivo em N threads (motor hash) ou N livros ao mesmo tempo\n"
+            "  --readers N           threads que leem os livros com vários livros (padrão: 2)\n"
+            "  --approx              modo aproximado em memória fixa (Space-Saving)\n"
+            "  --count-min           usa um sketch Count-Min no modo aproximado\n"
+            "  --mem-budget BYTES    memória do modo aproximado ou em disco, com sufixo K, M ou G (padrão: 64M)\n"
+            "  --every N             no modo aproximado, emite o ranking a cada N palavras\n"
+            "  --external            contagem exata em disco, usando no máximo --mem-budget de memória\n"
+            "  --ngram K             ranking das sequências de K palavras consecutivas (até 16)\n"
+            "  --window N            ranking de cada janela de N palavras, em uma linha por janela\n"
+            "  --step S              avanço da janela, em palavras (padrão: N, janelas sem sobreposição)\n"
+            "  --chapters            ranking de cada capítulo (títulos com só um número romano)\n"
+            "  --follow              continua contando o que for acrescentado ao livro (inotify)\n"
+            "  --interval SEG        no modo --follow, intervalo mínimo entre os rankings (padrão: 1, máximo: 2147483)\n"
+            "  --fold                separa as palavras pelos caracteres UTF-8 e converte para minúsculas\n"
+            "  --stats               escreve na saída de erro o tempo de cada fase e contadores, em JSON\n",
+            program, program, program, program);
+}
+
+int main(int argc, char *argv[])
+{
+    // Comandos do índice binário e do servidor
+    if (argc > 1 && strcmp(argv[1], "build-index") == 0)
+        return run_build_index(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "query") == 0)
+        return run_query(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "serve") == 0)
+        return run_serve(argc, argv);
+
+    engine counting_engine = ENGINE_HASH;   // Motor utilizado para contar as palavras
+    int threads = 1;                        // Quantidade de threads utilizadas na contagem
+    bool approx = false;                    // Modo aproximado (Space-Saving)
+    bool external_mode = false;             // Contagem exata com arquivos temporários
+    bool count_min = false;                 // Usa o sketch Count-Min no modo aproximado
+    size_t mem_budget = DEFAULT_MEM_BUDGET; // Orçamento de memória do modo aproximado
+    size_t every = 0;                       // Intervalo (em palavras) entre os rankings do modo aproximado
+    int readers = DEFAULT_READERS;          // Threads de leitura do modo corpus
+    bool stats = false;                     // Escreve as estatísticas ao terminar
+    int ngram = 0;                          // Palavras por sequência no modo de sequências (0: desativado)
+    size_t window = 0;                      // Palavras por janela no modo de janelas (0: desativado)
+    size_t step = 0;                        // Avanço da janela (0: o tamanho da janela)
+    bool chapters = false;                  // Ranking de cada capítulo
+    bool follow = false;                    // Continua contando o que for acrescentado ao livro
+    double interval = DEFAULT_INTERVAL;     // Intervalo mínimo (em segundos) entre os rankings do modo --follow
+    const char *positional[argc];           // 'n' e caminhos dos livros, quando passados como argumentos
+    int positional_count = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--engine=hash") == 0)
+            counting_engine = ENGINE_HASH;
+        else if (strcmp(argv[i], "--engine=sort") == 0)
+            counting_engine = ENGINE_SORT;
+        else if (strcmp(argv[i], "--threads") == 0 && value && (threads = atoi(value)) > 0)
+            i++;
+        else if (strcmp(argv[i], "--approx") == 0)
+            approx = true;
+        else if (strcmp(argv[i], "--external") == 0)
+            external_mode = true;
+        else if (strcmp(argv[i], "--count-min") == 0)
+            count_min = true;
+        else if (strcmp(argv[i], "--mem-budget") == 0 && value && parse_size(value, &mem_budget))
+            i++;
+        else if (strcmp(argv[i], "--every") == 0 && value && parse_size(value, &every))
+            i++;
+        else if (strcmp(argv[i], "--readers") == 0 && value && (readers = atoi(value)) > 0)
+            i++;
+        else if (strcmp(argv[i], "--stats") == 0)
+            stats = true;
+        else if (strcmp(argv[i], "--fold") == 0)
+            tokenizer_set_fold(true);
+        else if (strcmp(argv[i], "--ngram") == 0 && value && (ngram = atoi(value)) > 0)
+            i++;
+        else if (strcmp(argv[i], "--window") == 0 && value && parse_size(value, &window))
+            i++;
+        else if (strcmp(argv[i], "--step") == 0 && value && parse_size(value, &step))
+            i++;
+        else if (strcmp(argv[i], "--chapters") == 0)
+            chapters = true;
+        else if (strcmp(argv[i], "--follow") == 0)
+            follow = true;
+        else if (strcmp(argv[i], "--interval") == 0 && value && (interval = atof(value)) > 0 && interval <= MAX_INTERVAL)
+            i++;
+        else if (argv[i][0] != '-' || strcmp(argv[i], "-") == 0)
+            positional[positional_count++] = argv[i];
         else
         {
-            temp_word.word = atual;
-            dynvec_push(vec_sorted, &temp_word);
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    if (threads > 1 && (counting_engine != ENGINE_HASH || approx || external_mode) && positional_count <= 2)
+    {
+        fprintf(stderr, "--threads só pode ser utilizado com --engine=hash\n");
+        return -1;
+    }
+    if (approx && external_mode)
+    {
+        fprintf(stderr, "--approx e --external não podem ser utilizados juntos\n");
+        return -1;
+    }
+    if (ngram > NGRAM_MAX_K)
+    {
+        fprintf(stderr, "--ngram aceita no máximo %d palavras\n", NGRAM_MAX_K);
+        return -1;
+    }
+    if (ngram > 0 && (counting_engine != ENGINE_HASH || approx || external_mode || threads > 1 || positional_count > 2))
+    {
+        fprintf(stderr, "--ngram só pode ser utilizado com um livro, --engine=hash e uma thread\n");
+        return -1;
+    }
+    if ((window > 0 || chapters) && (counting_engine != ENGINE_HASH || approx || external_mode || ngram > 0 || follow || threads > 1 || positional_count > 2))
+    {
+        fprintf(stderr, "--window e --chapters só podem ser utilizados com um livro, --engine=hash e uma thread\n");
+        return -1;
+    }
+    if (window > 0 && chapters)
+    {
+        fprintf(stderr, "--window e --chapters não podem ser utilizados juntos\n");
+        return -1;
+    }
+    if (step > 0 && window == 0)
+    {
+        fprintf(stderr, "--step só pode ser utilizado com --window\n");
+        return -1;
+    }
+    if (follow && (counting_engine != ENGINE_HASH || approx || external_mode || ngram > 0 || threads > 1 || positional_count > 2))
+    {
+        fprintf(stderr, "--follow só pode ser utilizado com um livro, --engine=hash e uma thread\n");
+        return -1;
+    }
+    if (stats && !STATS_ENABLED)
+    {
+        fprintf(stderr, "--stats não está disponível: o programa foi compilado com STATS=0\n");
+        return -1;
+    }
+    // As estatísticas são escritas em qualquer saída do programa, inclusive nos erros
+    if (stats)
+        atexit(print_stats);
+
+    // Vários livros ou um diretório: modo corpus
+    if (positional_count > 2 || (positional_count == 2 && is_directory(positional[1])))
+    {
+        if (counting_engine != ENGINE_HASH || approx || external_mode)
+        {
+            fprintf(stderr, "Vários livros só podem ser contados com --engine=hash\n");
+            return -1;
+        }
+        int n = atoi(positional[0]);
+        return run_corpus(n > 0 ? (size_t)n : 0, positional + 1, positional_count - 1, readers, threads);
+    }
+
+    int n;
+    char book_path[200]; // Guarda o caminho do livro à ser lido
+
+    if (positional_count > 0)
+        n = atoi(positional[0]);
+    else if (scanf("%d", &n) != 1) // Lê quantas palavras o usuário quer e guarda na variável 'n'
+        return -1;
+
+    if (positional_count > 1)
+        snprintf(book_path, sizeof(book_path), "%s", positional[1]);
+    else
+    {
+        if (scanf("%199s", book_path) != 1)
+            return -1;
+        getchar(); // Consome o '\n' deixado no buffer
+    }
+
+    // O modo --follow lê o arquivo por conta própria, acompanhando o seu crescimento
+    if (follow)
+    {
+        if (strcmp(book_path, "-") == 0)
+        {
+            fprintf(stderr, "--follow precisa de um arquivo\n");
+            return -1;
+        }
+        return run_follow(book_path, n > 0 ? (size_t)n : 0, (long long)(interval * 1000));
+    }
+
+    // Tokenizador que percorre o arquivo mapeado em memória. Na contagem em disco o arquivo
+    // é lido em blocos, para que a memória usada não dependa do tamanho do arquivo.
+    STATS_PHASE_BEGIN(STATS_READ);
+    tokenizer *tk = (external_mode && strcmp(book_path, "-") != 0) ? tokenizer_open_blocks(book_path) : open_input(book_path);
+    STATS_PHASE_END(STATS_READ);
+    if (!tk)
+    {
+        perror("Error opening file"); // Emite um erro caso não seja possível ler o arquivo
+        return -1;
+    }
+
+    if (n < 0)
+        n = 0;
+
+    if (ngram > 0)
+    {
+        int result = run_ngram(tk, n, ngram);
+        tokenizer_close(tk);
+        return result;
+    }
+
+    if (window > 0 || chapters)
+    {
+        int result = chapters ? run_chapters(tk, n) : run_window(tk, n, window, step > 0 ? step : window);
+        tokenizer_close(tk);
+        return result;
+    }
+
+    if (approx)
+    {
+        int result = run_approx(tk, n, mem_budget, count_min, every);
+        tokenizer_close(tk);
+        return result;
+    }
+
+    token tok; // Visão da palavra atual dentro do arquivo
+
+    arena *words = NULL;         // Arena onde as palavras lidas são guardadas (motor "sort")
+    handle_vec *vec_input = NULL; // Vetor com os handles de todas as palavras lidas no arquivo (motor "sort")
+    wordmap *map = NULL;          // Tabela com as aparições de cada palavra (motor "hash")
+    word_vec *vec_sorted = NULL;  // Vetor com as 'n' palavras mais usadas, da mais usada para a menos usada
+    size_t unique = 0;            // Quantidade de palavras distintas
+
+    if (external_mode)
+    {
+        // Conta em uma tabela limitada a 'mem_budget', gravando runs ordenados em disco quando ela enche
+        STATS_PHASE_BEGIN(STATS_TOKENIZE);
+        external *ex = external_create(mem_budget);
+        bool ok = ex != NULL;
+        while (ok && tokenizer_next(tk, &tok))
+            ok = external_add(ex, tok.ptr, tok.len);
+        STATS_PHASE_END(STATS_TOKENIZE);
+
+        // Mescla os runs e seleciona as 'n' palavras mais usadas sem guardar o vocabulário inteiro
+        STATS_PHASE_BEGIN(STATS_MERGE);
+        top_accumulator acc = {n, word_vec_create(), arena_create(), 0};
+        ok = ok && acc.words && acc.store && external_finish(ex, top_accumulate, &acc);
+        external_free(ex);
+        STATS_PHASE_END(STATS_MERGE);
+        if (!ok)
+        {
+            perror("Error counting words");
+            return -1;
+        }
+        STATS_PHASE_BEGIN(STATS_SELECT);
+        vec_sorted = word_vec_top_k(acc.words, n);
+        STATS_PHASE_END(STATS_SELECT);
+        unique = acc.unique;
+        word_vec_free(acc.words);
+        words = acc.store;
+        if (!vec_sorted)
+        {
+            perror("Error counting words");
+            return -1;
+        }
+    }
+    else if (counting_engine == ENGINE_HASH)
+    {
+        STATS_PHASE_BEGIN(STATS_TOKENIZE);
+        map = count_words(tk, threads);
+        STATS_PHASE_END(STATS_TOKENIZE);
+        if (!map)
+        {
+            perror("Error counting words");
+            return -1;
+        }
 
-            temp_word.times = 1;
+        // Seleciona as 'n' entradas mais frequentes direto da tabela, sem copiar o vocabulário inteiro
+        STATS_PHASE_BEGIN(STATS_SELECT);
+        dynvec *top = dynvec_top_k(wordmap_entries(map), n, wordmap_rank_comp);
+        vec_sorted = word_vec_create();
+        bool ok = top && vec_sorted;
+        for (size_t i = 0; ok && i < dynvec_length(top); i++)
+        {
+            wordmap_entry *entry = (wordmap_entry *)dynvec_get(top, i);
+            word temp_word = {entry->word, entry->times};
+            ok = word_vec_push(vec_sorted, temp_word);
+        }
+        dynvec_free(top);
+        STATS_PHASE_END(STATS_SELECT);
+        if (!ok)
+        {
+            perror("Error counting words");
+            return -1;
+        }
+        unique = wordmap_length(map);
+    }
+    else
+    {
+        words = arena_create();
+        vec_input = handle_vec_create();
+        if (!words || !vec_input)
+        {
+            perror("Error counting words");
+            return -1;
         }
+
+        // Cada palavra ocupa apenas o seu tamanho na arena, sem limite de tamanho
+        STATS_PHASE_BEGIN(STATS_TOKENIZE);
+        while (tokenizer_next(tk, &tok))
+        {
+            word_handle handle = arena_store(words, tok.ptr, tok.len);
+            if (!handle || !handle_vec_push(vec_input, handle))
+            {
+                perror("Error counting words");
+                return -1;
+            }
+        }
+
+        STATS_PHASE_END(STATS_TOKENIZE);
+
+        // Ordena as palavras com o multikey quicksort, que não compara de novo os prefixos comuns
+        STATS_PHASE_BEGIN(STATS_SORT);
+        multikey_quicksort(vec_input->data, handle_vec_length(vec_input));
+        STATS_PHASE_END(STATS_SORT);
+
+        word_vec *vec_counts = word_vec_create(); // Vetor auxiliar para guardar as palavras com sua quantidade de aparições
+        if (!vec_counts)
+        {
+            perror("Error counting words");
+            return -1;
+        }
+        word temp_word;
+        temp_word.times = 1; // Iniciliza em 1, pois cada palavra aparece pelo menos 1 vez
+
+        // Copia os elementos de "vec_input" para "vec_counts", contando quantas aparições tem cada palavra
+        STATS_PHASE_BEGIN(STATS_RUN_LENGTH);
+        for (size_t i = 0; i < handle_vec_length(vec_input); i++)
+        {
+            word_handle *atual = handle_vec_get(vec_input, i);
+
+            // Caso a palavra atual e a seguinte sejam iguais, incrementa a sua aparição
+            if (i + 1 != handle_vec_length(vec_input) && string_comp(atual, handle_vec_get(vec_input, i + 1)) == 0)
+            {
+                temp_word.times++;
+            }
+            // Caso o contrário, guarda ela no vetor e reinicia as aparições para a próxima
+            else
+            {
+                temp_word.word = *atual;
+                if (!word_vec_push(vec_counts, temp_word))
+                {
+                    perror("Error counting words");
+                    return -1;
+                }
+
+                temp_word.times = 1;
+            }
+        }
+
+        STATS_PHASE_END(STATS_RUN_LENGTH);
+
+        // Seleciona as 'n' palavras mais frequentes
+        STATS_PHASE_BEGIN(STATS_SELECT);
+        vec_sorted = word_vec_top_k(vec_counts, n);
+        STATS_PHASE_END(STATS_SELECT);
+        unique = word_vec_length(vec_counts);
+        word_vec_free(vec_counts);
+        if (!vec_sorted)
+        {
+            perror("Error counting words");
+            return -1;
+        }
+    }
+
+    bool read_error = tokenizer_error(tk);
+    tokenizer_close(tk); // Fecha o arquivo
+
+    if (read_error || unique == 0 || !vec_sorted)
+    {
+        perror("Error reading file");
+        return -1;
     }
 
-    void *auxiliar = malloc((dynvec_length(vec_sorted)) * (dynvec_elem_size(vec_sorted))); // Vetor auxiliar para realizar o mergesort
-    mergesort_dynvec(vec_sorted, auxiliar, word_times_comp, 0, dynvec_length(vec_sorted)); // Realizar o mergesort para ordenar o vetor por ordem de aparição
+    STATS_ADD(STATS_UNIQUE_WORDS, unique);
 
     // Escreve no console as 'n' palavras mais usadas do livro
-    for (int i = dynvec_length(vec_sorted) - 1, j = 1; i >= 0 && n > 0; i--, n--, j++)
+    STATS_PHASE_BEGIN(STATS_OUTPUT);
+    for (size_t i = 0; i < word_vec_length(vec_sorted); i++)
     {
-        word *tmp_word = (word *)dynvec_get(vec_sorted, (size_t)i);
-        printf("%dº: \"%s\", %zu aparições\n", j, tmp_word->word, tmp_word->times);
+        word *tmp_word = word_vec_get(vec_sorted, i);
+        printf("%zuº: \"%s\", %zu aparições\n", i + 1, tmp_word->word, tmp_word->times);
     }
+    fflush(stdout);
+    STATS_PHASE_END(STATS_OUTPUT);
 
     // Libera os vetores utilizados na memória
-    free(auxiliar);
-    dynvec_free(vec_input);
-    dynvec_free(vec_sorted);
+    handle_vec_free(vec_input);
+    arena_free(words);
+    wordmap_free(map);
+    word_vec_free(vec_sorted);
 
     return 0;
 }
\ No newline at end of file
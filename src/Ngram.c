@@ -0,0 +1,252 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <GenericDynvec.h>
+#include <Arena.h>
+#include <Wordmap.h>
+#include <Stats.h>
+#include <Ngram.h>
+
+// Base do hash polinomial das sequências (ímpar, para que a multiplicação seja inversível)
+#define NGRAM_BASE 0x100000001b3ULL
+
+// Posição da tabela de endereçamento aberto (mesmo formato da tabela de palavras)
+typedef struct Slot
+{
+    uint32_t tag;   // 32 bits mais altos do hash, para descartar colisões sem acessar a chave
+    uint32_t index; // Índice da entrada em 'entries' mais 1 (0 indica posição vazia)
+} Slot;
+
+// Estrutura que representa a tabela de sequências
+typedef struct Intngrammap
+{
+    size_t k;        // Palavras por sequência
+    wordmap *vocab;  // Vocabulário: dá a cada palavra um handle único
+    Slot *slots;     // Posições da tabela
+    size_t capacity; // Quantidade de posições (potência de 2)
+    dynvec *entries; // Entradas (ngram_entry)
+    arena *keys;     // Arena com as chaves (handles das palavras) das sequências distintas
+
+    // Buffer circular com as últimas K palavras. Cada handle é escrito nas posições 'i' e 'i + k',
+    // de forma que as K últimas palavras, da mais antiga para a mais recente, sempre estão
+    // contíguas a partir de 'window + start'
+    const char *window[2 * NGRAM_MAX_K];
+    uint64_t hashes[NGRAM_MAX_K]; // Hashes das palavras do buffer (para retirá-las do hash deslizante)
+    size_t start;                 // Posição da palavra mais antiga no buffer
+    size_t filled;                // Quantidade de palavras já lidas no buffer (até k)
+    uint64_t rolling;             // Soma de hash(palavra i) * BASE^(k - 1 - i) das palavras do buffer
+    uint64_t top_power;           // BASE^(k - 1)
+} ngrammap;
+
+/*-------------------------------------------------------
+   Funções auxiliares
+-------------------------------------------------------*/
+
+// Função auxiliar: espalha os bits do hash deslizante, cujos bits baixos dependem pouco das palavras antigas
+static inline uint64_t finish_hash(uint64_t h)
+{
+    h ^= h >> 32;
+    h *= 0xd6e8feb86659fd93ULL;
+    h ^= h >> 32;
+    return h;
+}
+
+// Função auxiliar: posição da sequência 'key' (ou a posição vazia onde ela deve ser inserida)
+static Slot *find_slot(ngrammap *nm, const char *const *key, uint64_t hash)
+{
+    size_t mask = nm->capacity - 1;
+    uint32_t tag = (uint32_t)(hash >> 32);
+    size_t key_size = nm->k * sizeof(char *);
+
+    for (size_t i = (size_t)hash & mask;; i = (i + 1) & mask)
+    {
+        Slot *slot = &nm->slots[i];
+        if (slot->index == 0)
+            return slot;
+        if (slot->tag == tag)
+        {
+            // As palavras são comparadas pelos handles, que são únicos por palavra
+            ngram_entry *entry = dynvec_get(nm->entries, slot->index - 1);
+            if (memcmp(entry->key, key, key_size) == 0)
+                return slot;
+        }
+    }
+}
+
+// Função auxiliar: dobra a capacidade da tabela, reposicionando as entradas existentes
+static bool ngrammap_grow(ngrammap *nm)
+{
+    size_t new_capacity = nm->capacity * 2;
+    Slot *new_slots = calloc(new_capacity, sizeof(Slot));
+    if (!new_slots)
+        return false;
+    STATS_INC(STATS_ALLOCATIONS);
+
+    size_t mask = new_capacity - 1;
+    for (size_t i = 0; i < nm->capacity; i++)
+    {
+        Slot slot = nm->slots[i];
+        if (slot.index == 0)
+            continue;
+        ngram_entry *entry = dynvec_get(nm->entries, slot.index - 1);
+        size_t j = (size_t)entry->hash & mask;
+        while (new_slots[j].index != 0)
+            j = (j + 1) & mask;
+        new_slots[j] = slot;
+    }
+
+    free(nm->slots);
+    nm->slots = new_slots;
+    nm->capacity = new_capacity;
+    return true;
+}
+
+// Função auxiliar: conta uma aparição da sequência 'key' (k handles)
+static bool count_sequence(ngrammap *nm, const char *const *key, uint64_t hash)
+{
+    Slot *slot = find_slot(nm, key, hash);
+    if (slot->index != 0)
+    {
+        ((ngram_entry *)dynvec_get(nm->entries, slot->index - 1))->times++;
+        return true;
+    }
+
+    // Mantém a ocupação abaixo de 3/4 para que as sequências de sondagem fiquem curtas
+    if ((dynvec_length(nm->entries) + 1) * 4 > nm->capacity * 3)
+    {
+        if (!ngrammap_grow(nm))
+            return false;
+        slot = find_slot(nm, key, hash);
+    }
+
+    ngram_entry entry = {arena_store(nm->keys, (const char *)key, nm->k * sizeof(char *)), 1, hash};
+    if (!entry.key || !dynvec_push(nm->entries, &entry))
+        return false;
+    slot->tag = (uint32_t)(hash >> 32);
+    slot->index = (uint32_t)dynvec_length(nm->entries);
+    return true;
+}
+
+// Função auxiliar: compara duas sequências pela quantidade de aparições, desempatando pelas
+// palavras, uma a uma (mesma ordem que comparar os textos das sequências separados por espaço)
+static int ngram_rank_comp(const void *key, const void *elem)
+{
+    const ngram_entry *a = (const ngram_entry *)key;
+    const ngram_entry *b = (const ngram_entry *)elem;
+    if (a->times != b->times)
+        return (a->times > b->times) ? 1 : -1;
+    for (size_t j = 0; j < ngram_length(a); j++)
+    {
+        int comp = strcmp(ngram_word(a, j), ngram_word(b, j));
+        if (comp)
+            return comp;
+    }
+    return 0;
+}
+
+/*-------------------------------------------------------
+   Funções da tabela de sequências
+-------------------------------------------------------*/
+
+// Cria uma tabela que conta as sequências de 'k' palavras consecutivas
+ngrammap *ngrammap_create(size_t k)
+{
+    if (k < 1 || k > NGRAM_MAX_K)
+        return NULL;
+    ngrammap *nm = calloc(1, sizeof(ngrammap));
+    if (!nm)
+        return NULL;
+
+    nm->k = k;
+    nm->capacity = WORDMAP_INIT_CAPACITY;
+    nm->vocab = wordmap_create();
+    nm->slots = calloc(nm->capacity, sizeof(Slot));
+    nm->entries = dynvec_create(sizeof(ngram_entry));
+    nm->keys = arena_create();
+    STATS_ADD(STATS_ALLOCATIONS, 2);
+    nm->top_power = 1;
+    for (size_t i = 1; i < k; i++)
+        nm->top_power *= NGRAM_BASE;
+    if (!nm->vocab || !nm->slots || !nm->entries || !nm->keys)
+    {
+        ngrammap_free(nm);
+        return NULL;
+    }
+    return nm;
+}
+
+// Recebe a próxima palavra do texto, contando a sequência que termina nela
+bool ngrammap_add(ngrammap *nm, const char *word, size_t len)
+{
+    wordmap_entry *entry = wordmap_intern(nm->vocab, word, len);
+    if (!entry)
+        return false;
+
+    size_t k = nm->k;
+    size_t i;
+    if (nm->filled < k)
+    {
+        // O buffer ainda não tem k palavras: a nova palavra vai para o fim
+        i = nm->filled++;
+    }
+    else
+    {
+        // Retira a palavra mais antiga do hash e põe a nova no seu lugar no buffer
+        i = nm->start;
+        nm->rolling -= nm->hashes[i] * nm->top_power;
+        nm->start = (i + 1 == k) ? 0 : i + 1;
+    }
+    nm->window[i] = nm->window[i + k] = entry->word;
+    nm->hashes[i] = entry->hash;
+    nm->rolling = nm->rolling * NGRAM_BASE + entry->hash;
+
+    if (nm->filled < k)
+        return true;
+    return count_sequence(nm, nm->window + nm->start, finish_hash(nm->rolling));
+}
+
+// Retorna o número de sequências distintas
+size_t ngrammap_length(ngrammap *nm)
+{
+    return dynvec_length(nm->entries);
+}
+
+// Retorna a tabela com o vocabulário
+wordmap *ngrammap_words(ngrammap *nm)
+{
+    return nm->vocab;
+}
+
+// Retorna um novo vetor com as 'n' sequências mais frequentes
+dynvec *ngrammap_top(ngrammap *nm, size_t n)
+{
+    return dynvec_top_k(nm->entries, n, ngram_rank_comp);
+}
+
+// Retorna a quantidade de palavras de uma sequência
+size_t ngram_length(const ngram_entry *entry)
+{
+    return arena_len(entry->key) / sizeof(char *);
+}
+
+// Retorna a palavra 'j' da sequência (a chave na arena não é alinhada: o handle é copiado)
+const char *ngram_word(const ngram_entry *entry, size_t j)
+{
+    const char *word;
+    memcpy(&word, entry->key + j * sizeof(char *), sizeof(char *));
+    return word;
+}
+
+// Libera a memória da tabela, de suas sequências e do vocabulário
+void ngrammap_free(ngrammap *nm)
+{
+    if (!nm)
+        return;
+    wordmap_free(nm->vocab);
+    free(nm->slots);
+    dynvec_free(nm->entries);
+    arena_free(nm->keys);
+    free(nm);
+}
@@ -0,0 +1,503 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <GenericDynvec.h>
+#include <Wordmap.h>
+#include <Tokenizer.h>
+#include <Server.h>
+
+// Livro carregado em memória
+typedef struct Book
+{
+    const char *path;      // Caminho do livro
+    const char *name;      // Nome do livro nos pedidos (caminho sem os diretórios)
+    pthread_rwlock_t lock; // Consultas pegam a trava para leitura; RELOAD, para escrita, só na troca
+    wordmap *map;          // Tabela com as aparições de cada palavra
+    dynvec *ranking;       // Ranking completo (wordmap_entry), da mais usada para a menos usada
+    size_t words;          // Quantidade total de palavras
+} Book;
+
+// Estrutura que representa o servidor
+typedef struct Server
+{
+    Book *books;  // Livros carregados
+    size_t count; // Quantidade de livros
+    bool fold;    // Normaliza as palavras de COUNT
+
+    pthread_mutex_t lock;             // Protege a fila e os campos abaixo
+    pthread_cond_t not_empty;         // Sinaliza que há conexões na fila (ou que o servidor vai parar)
+    int queue[SERVER_QUEUE_SIZE];     // Fila circular de conexões aceitas
+    size_t head;                      // Posição da primeira conexão da fila
+    size_t queued;                    // Quantidade de conexões na fila
+    bool stopping;                    // Indica que o servidor vai parar
+    int *active;                      // Conexão atendida por cada thread (-1 se nenhuma)
+} Server;
+
+// Estado de uma thread de atendimento
+typedef struct Worker
+{
+    Server *s; // Servidor
+    int id;    // Posição da thread em 'active'
+} Worker;
+
+// Indica que SIGINT ou SIGTERM chegou
+static volatile sig_atomic_t stop_requested = 0;
+
+/*-------------------------------------------------------
+   Funções auxiliares
+-------------------------------------------------------*/
+
+// Função auxiliar: tratador de SIGINT e SIGTERM
+static void on_stop_signal(int signal)
+{
+    (void)signal;
+    stop_requested = 1;
+}
+
+// Função auxiliar: conta as palavras do livro e monta o seu ranking completo. Retorna false em caso de erro
+static bool count_book(const char *path, wordmap **map, dynvec **ranking, size_t *words)
+{
+    tokenizer *tk = tokenizer_open(path);
+    if (!tk)
+        return false;
+    *map = wordmap_create();
+    *words = 0;
+    token tok;
+    bool ok = *map != NULL;
+    while (ok && tokenizer_next(tk, &tok))
+    {
+        ok = wordmap_add(*map, tok.ptr, tok.len, 1);
+        (*words)++;
+    }
+    if (ok && tokenizer_error(tk))
+        ok = false;
+    else if (!ok)
+        errno = ENOMEM;
+    tokenizer_close(tk);
+
+    *ranking = ok ? dynvec_top_k(wordmap_entries(*map), wordmap_length(*map), wordmap_rank_comp) : NULL;
+    if (!*ranking)
+    {
+        if (ok)
+            errno = ENOMEM;
+        wordmap_free(*map);
+        *map = NULL;
+        return false;
+    }
+    return true;
+}
+
+// Função auxiliar: procura o livro pelo nome. Retorna NULL se ele não existir
+static Book *find_book(Server *s, const char *name)
+{
+    for (size_t i = 0; name && i < s->count; i++)
+    {
+        if (strcmp(s->books[i].name, name) == 0)
+            return &s->books[i];
+    }
+    return NULL;
+}
+
+// Função auxiliar: escreve todos os bytes no socket. Retorna false se a conexão foi fechada
+static bool write_all(int fd, const char *data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t count = write(fd, data, size);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            return false;
+        data += count;
+        size -= (size_t)count;
+    }
+    return true;
+}
+
+// Função auxiliar: responde um pedido em 'out'. Retorna false se o cliente pediu para encerrar
+static bool handle_request(Server *s, char *line, FILE *out)
+{
+    char *save;
+    const char *command = strtok_r(line, " \t\r\n", &save);
+    const char *arg1 = command ? strtok_r(NULL, " \t\r\n", &save) : NULL;
+    const char *arg2 = arg1 ? strtok_r(NULL, " \t\r\n", &save) : NULL;
+    bool extra = arg2 && strtok_r(NULL, " \t\r\n", &save) != NULL;
+
+    if (!command)
+        fprintf(out, "ERR empty request\n");
+    else if (strcmp(command, "QUIT") == 0)
+        return false;
+    else if (strcmp(command, "LIST") == 0 && !arg1)
+    {
+        fprintf(out, "OK %zu\n", s->count);
+        for (size_t i = 0; i < s->count; i++)
+        {
+            Book *book = &s->books[i];
+            pthread_rwlock_rdlock(&book->lock);
+            fprintf(out, "%s %zu %zu\n", book->name, book->words, wordmap_length(book->map));
+            pthread_rwlock_unlock(&book->lock);
+        }
+    }
+    else if (strcmp(command, "TOP") == 0)
+    {
+        Book *book = find_book(s, arg1);
+        char *end = NULL;
+        unsigned long long n = arg2 ? strtoull(arg2, &end, 10) : 0;
+        if (!arg2 || extra || *end != '\0' || arg2[0] == '-')
+            fprintf(out, "ERR usage: TOP <book> <n>\n");
+        else if (!book)
+            fprintf(out, "ERR unknown book\n");
+        else
+        {
+            pthread_rwlock_rdlock(&book->lock);
+            size_t length = dynvec_length(book->ranking);
+            if (n > length)
+                n = length;
+            fprintf(out, "OK %llu\n", n);
+            for (size_t i = 0; i < n; i++)
+            {
+                const wordmap_entry *entry = (const wordmap_entry *)dynvec_get(book->ranking, i);
+                fprintf(out, "%s %zu\n", entry->word, entry->times);
+            }
+            pthread_rwlock_unlock(&book->lock);
+        }
+    }
+    else if (strcmp(command, "COUNT") == 0)
+    {
+        Book *book = find_book(s, arg1);
+        if (!arg2 || extra)
+            fprintf(out, "ERR usage: COUNT <book> <word>\n");
+        else if (!book)
+            fprintf(out, "ERR unknown book\n");
+        else
+        {
+            // Com normalização, a palavra passa pelo mesmo tokenizador que normalizou o livro
+            const char *word = arg2;
+            size_t len = strlen(arg2);
+            tokenizer *tk = s->fold ? tokenizer_open_buffer(arg2, len) : NULL;
+            token tok = {word, 0};
+            if (tk && tokenizer_next(tk, &tok))
+                word = tok.ptr, len = tok.len;
+            else if (s->fold)
+                len = 0;
+
+            pthread_rwlock_rdlock(&book->lock);
+            size_t times = (len > 0) ? wordmap_get(book->map, word, len) : 0;
+            pthread_rwlock_unlock(&book->lock);
+            fprintf(out, "OK 1\n%s %zu\n", arg2, times);
+            tokenizer_close(tk);
+        }
+    }
+    else if (strcmp(command, "RELOAD") == 0)
+    {
+        Book *book = find_book(s, arg1);
+        wordmap *map;
+        dynvec *ranking;
+        size_t words;
+        if (!arg1 || arg2)
+            fprintf(out, "ERR usage: RELOAD <book>\n");
+        else if (!book)
+            fprintf(out, "ERR unknown book\n");
+        else if (!count_book(book->path, &map, &ranking, &words))
+            fprintf(out, "ERR %s\n", strerror(errno));
+        else
+        {
+            // A contagem foi feita sem a trava: as consultas só esperam a troca dos ponteiros
+            pthread_rwlock_wrlock(&book->lock);
+            wordmap *old_map = book->map;
+            dynvec *old_ranking = book->ranking;
+            book->map = map;
+            book->ranking = ranking;
+            book->words = words;
+            // Depois de liberar a trava, outro RELOAD pode trocar (e liberar) 'map'
+            size_t unique = wordmap_length(map);
+            pthread_rwlock_unlock(&book->lock);
+            dynvec_free(old_ranking);
+            wordmap_free(old_map);
+            fprintf(out, "OK 1\n%s %zu %zu\n", book->name, words, unique);
+        }
+    }
+    else
+        fprintf(out, "ERR unknown command\n");
+    return true;
+}
+
+// Função auxiliar: atende uma conexão até o cliente desconectar ou enviar QUIT
+static void serve_client(Server *s, int fd)
+{
+    FILE *in = fdopen(fd, "r");
+    char *response = NULL;
+    size_t response_size = 0;
+    FILE *out = open_memstream(&response, &response_size);
+    if (!in || !out)
+    {
+        if (in)
+            fclose(in);
+        else
+            close(fd);
+        if (out)
+            fclose(out);
+        free(response);
+        return;
+    }
+
+    // A resposta é montada em memória e enviada de uma vez, fora das travas dos livros
+    char *line = NULL;
+    size_t line_capacity = 0;
+    ssize_t len;
+    bool open = true;
+    while (open && (len = getline(&line, &line_capacity, in)) > 0)
+    {
+        rewind(out);
+        if (len > SERVER_LINE_MAX)
+        {
+            fprintf(out, "ERR request too long\n");
+            open = false;
+        }
+        else
+            open = handle_request(s, line, out);
+        fflush(out);
+        if (response_size > 0 && !write_all(fd, response, response_size))
+            open = false;
+    }
+
+    free(line);
+    fclose(out);
+    free(response);
+    fclose(in);
+}
+
+// Thread de atendimento: tira as conexões da fila e atende cada uma, até o servidor parar
+static void *worker_thread(void *arg)
+{
+    Worker *worker = (Worker *)arg;
+    Server *s = worker->s;
+    for (;;)
+    {
+        pthread_mutex_lock(&s->lock);
+        while (s->queued == 0 && !s->stopping)
+            pthread_cond_wait(&s->not_empty, &s->lock);
+        if (s->stopping)
+        {
+            pthread_mutex_unlock(&s->lock);
+            break;
+        }
+        int fd = s->queue[s->head];
+        s->head = (s->head + 1) % SERVER_QUEUE_SIZE;
+        s->queued--;
+        s->active[worker->id] = fd;
+        pthread_mutex_unlock(&s->lock);
+
+        serve_client(s, fd);
+
+        pthread_mutex_lock(&s->lock);
+        s->active[worker->id] = -1;
+        pthread_mutex_unlock(&s->lock);
+    }
+    return NULL;
+}
+
+// Função auxiliar: cria o socket, recusando um caminho em uso por outro servidor. Retorna -1 em caso de erro
+static int open_socket(const char *path)
+{
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    if (strlen(path) >= sizeof(addr.sun_path))
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+
+    // Um socket que ninguém atende sobrou de um servidor anterior e pode ser removido
+    struct stat st;
+    if (stat(path, &st) == 0 && S_ISSOCK(st.st_mode))
+    {
+        if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0)
+        {
+            close(fd);
+            errno = EADDRINUSE;
+            return -1;
+        }
+        close(fd);
+        unlink(path);
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+            return -1;
+    }
+
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, SERVER_QUEUE_SIZE) != 0)
+    {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return -1;
+    }
+    return fd;
+}
+
+/*-------------------------------------------------------
+   Funções do servidor
+-------------------------------------------------------*/
+
+// Carrega os livros e atende pedidos no socket até receber SIGINT ou SIGTERM
+bool server_run(const char *socket_path, const char **paths, size_t count, int workers, bool fold)
+{
+    if (workers < 1)
+        workers = 1;
+
+    Server s = {.count = count, .fold = fold};
+    pthread_mutex_init(&s.lock, NULL);
+    pthread_cond_init(&s.not_empty, NULL);
+    s.books = calloc(count, sizeof(Book));
+    s.active = malloc(workers * sizeof(int));
+    Worker *states = malloc(workers * sizeof(Worker));
+    pthread_t *ids = malloc(workers * sizeof(pthread_t));
+    bool ok = s.books && s.active && states && ids;
+    if (!ok)
+        errno = ENOMEM;
+
+    // Os livros são contados uma única vez, antes de aceitar conexões
+    size_t loaded = 0;
+    for (; ok && loaded < count; loaded++)
+    {
+        Book *book = &s.books[loaded];
+        book->path = paths[loaded];
+        const char *slash = strrchr(paths[loaded], '/');
+        book->name = slash ? slash + 1 : paths[loaded];
+        ok = count_book(book->path, &book->map, &book->ranking, &book->words);
+        if (!ok)
+        {
+            int saved = errno;
+            fprintf(stderr, "Error loading %s: %s\n", book->path, strerror(saved));
+            errno = saved;
+            break;
+        }
+        pthread_rwlock_init(&book->lock, NULL);
+    }
+
+    int listen_fd = ok ? open_socket(socket_path) : -1;
+    ok = ok && listen_fd >= 0;
+
+    // SIGINT e SIGTERM ficam bloqueados em todas as threads e só são recebidos pela thread
+    // principal enquanto ela espera conexões (ppoll), sem perder um sinal entre a verificação e a espera
+    sigset_t stop_signals, old_mask;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, &old_mask);
+    struct sigaction action = {.sa_handler = on_stop_signal}; // Sem SA_RESTART
+    sigemptyset(&action.sa_mask);
+    struct sigaction old_int, old_term, old_pipe;
+    sigaction(SIGINT, &action, &old_int);
+    sigaction(SIGTERM, &action, &old_term);
+    struct sigaction ignore = {.sa_handler = SIG_IGN}; // Clientes que desconectam não derrubam o servidor
+    sigemptyset(&ignore.sa_mask);
+    sigaction(SIGPIPE, &ignore, &old_pipe);
+
+    int started = 0;
+    for (; ok && started < workers; started++)
+    {
+        s.active[started] = -1;
+        states[started] = (Worker){&s, started};
+        int error = pthread_create(&ids[started], NULL, worker_thread, &states[started]);
+        if (error != 0)
+        {
+            // Com pelo menos uma thread o servidor funciona, só atendendo menos clientes ao mesmo tempo
+            ok = started > 0;
+            errno = error;
+            break;
+        }
+    }
+
+    if (ok)
+        fprintf(stderr, "Servidor pronto em %s (%zu livros, %d threads)\n", socket_path, count, started);
+    sigset_t wait_mask = old_mask;
+    sigdelset(&wait_mask, SIGINT);
+    sigdelset(&wait_mask, SIGTERM);
+    stop_requested = 0;
+    while (ok && !stop_requested)
+    {
+        struct pollfd pfd = {listen_fd, POLLIN, 0};
+        if (ppoll(&pfd, 1, NULL, &wait_mask) < 0)
+        {
+            if (errno != EINTR)
+                ok = false;
+            continue;
+        }
+        int fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+        if (fd < 0)
+            continue;
+
+        // Com a fila cheia, a conexão é recusada em vez de esperar: a thread principal nunca bloqueia
+        pthread_mutex_lock(&s.lock);
+        bool queued = s.queued < SERVER_QUEUE_SIZE;
+        if (queued)
+        {
+            s.queue[(s.head + s.queued) % SERVER_QUEUE_SIZE] = fd;
+            s.queued++;
+            pthread_cond_signal(&s.not_empty);
+        }
+        pthread_mutex_unlock(&s.lock);
+        if (!queued)
+        {
+            static const char busy[] = "ERR server busy\n";
+            write_all(fd, busy, sizeof(busy) - 1);
+            close(fd);
+        }
+    }
+    int saved = errno;
+
+    // Encerra as conexões em atendimento (as threads saem do getline) e as que esperam na fila
+    pthread_mutex_lock(&s.lock);
+    s.stopping = true;
+    for (int i = 0; i < started; i++)
+    {
+        if (s.active[i] >= 0)
+            shutdown(s.active[i], SHUT_RDWR);
+    }
+    pthread_cond_broadcast(&s.not_empty);
+    pthread_mutex_unlock(&s.lock);
+    for (int i = 0; i < started; i++)
+        pthread_join(ids[i], NULL);
+    for (; s.queued > 0; s.queued--, s.head = (s.head + 1) % SERVER_QUEUE_SIZE)
+        close(s.queue[s.head]);
+
+    if (listen_fd >= 0)
+    {
+        close(listen_fd);
+        unlink(socket_path);
+    }
+    sigaction(SIGINT, &old_int, NULL);
+    sigaction(SIGTERM, &old_term, NULL);
+    sigaction(SIGPIPE, &old_pipe, NULL);
+    pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+
+    for (size_t i = 0; i < loaded; i++)
+    {
+        pthread_rwlock_destroy(&s.books[i].lock);
+        dynvec_free(s.books[i].ranking);
+        wordmap_free(s.books[i].map);
+    }
+    pthread_mutex_destroy(&s.lock);
+    pthread_cond_destroy(&s.not_empty);
+    free(s.books);
+    free(s.active);
+    free(states);
+    free(ids);
+    errno = saved;
+    return ok;
+}
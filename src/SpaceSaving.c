@@ -0,0 +1,309 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <GenericDynvec.h>
+#include <Wordmap.h>
+#include <SpaceSaving.h>
+
+// Estimativa de bytes gastos por palavra monitorada (contador, heap, tabela e a própria palavra)
+#define BYTES_PER_COUNTER 96
+
+// Quantidade mínima de palavras monitoradas
+#define MIN_COUNTERS 16
+
+// Contador de uma palavra monitorada
+typedef struct Counter
+{
+    char *word;      // Palavra (terminada em '\0'), reaproveitada quando o contador é substituído
+    size_t len;      // Tamanho da palavra
+    size_t capacity; // Capacidade do buffer 'word'
+    uint64_t hash;   // Hash da palavra
+    size_t count;    // Estimativa de aparições
+    size_t error;    // Erro máximo da estimativa
+    size_t heap_pos; // Posição do contador no heap
+} Counter;
+
+// Estrutura que representa o Space-Saving
+typedef struct Intspacesaving
+{
+    Counter *counters; // Contadores
+    size_t used;       // Contadores em uso
+    size_t capacity;   // Quantidade máxima de contadores
+    size_t *heap;      // Heap de mínimo (por 'count') com os índices dos contadores
+    uint32_t *slots;   // Tabela hash (sondagem linear): índice do contador + 1, ou 0 se vazia
+    size_t slot_mask;  // Quantidade de posições da tabela - 1
+    uint64_t *sketch;  // Sketch Count-Min (COUNTMIN_DEPTH linhas), ou NULL
+    size_t width_mask; // Largura de cada linha do sketch - 1
+    size_t total;      // Total de palavras registradas
+    size_t evicted;    // Maior contagem já substituída: limita a contagem real de qualquer palavra não monitorada
+} spacesaving;
+
+/*-------------------------------------------------------
+   Funções auxiliares
+-------------------------------------------------------*/
+
+// Função auxiliar: maior potência de 2 menor ou igual a 'n' (n > 0)
+static size_t floor_pow2(size_t n)
+{
+    size_t p = 1;
+    while (p <= n / 2)
+        p *= 2;
+    return p;
+}
+
+// Função auxiliar: troca duas posições do heap, atualizando as posições guardadas nos contadores
+static void heap_swap(spacesaving *ss, size_t a, size_t b)
+{
+    size_t temp = ss->heap[a];
+    ss->heap[a] = ss->heap[b];
+    ss->heap[b] = temp;
+    ss->counters[ss->heap[a]].heap_pos = a;
+    ss->counters[ss->heap[b]].heap_pos = b;
+}
+
+// Função auxiliar: desce a posição 'i' do heap até restaurar a propriedade de heap de mínimo
+static void heap_sift_down(spacesaving *ss, size_t i)
+{
+    for (;;)
+    {
+        size_t smallest = i, l = 2 * i + 1, r = 2 * i + 2;
+        if (l < ss->used && ss->counters[ss->heap[l]].count < ss->counters[ss->heap[smallest]].count)
+            smallest = l;
+        if (r < ss->used && ss->counters[ss->heap[r]].count < ss->counters[ss->heap[smallest]].count)
+            smallest = r;
+        if (smallest == i)
+            return;
+        heap_swap(ss, i, smallest);
+        i = smallest;
+    }
+}
+
+// Função auxiliar: sobe a posição 'i' do heap até restaurar a propriedade de heap de mínimo
+static void heap_sift_up(spacesaving *ss, size_t i)
+{
+    while (i > 0)
+    {
+        size_t parent = (i - 1) / 2;
+        if (ss->counters[ss->heap[parent]].count <= ss->counters[ss->heap[i]].count)
+            return;
+        heap_swap(ss, i, parent);
+        i = parent;
+    }
+}
+
+// Função auxiliar: procura a posição da palavra na tabela ou a primeira posição vazia da sua sondagem
+static size_t find_slot(spacesaving *ss, const char *word, size_t len, uint64_t hash)
+{
+    for (size_t i = (size_t)hash & ss->slot_mask;; i = (i + 1) & ss->slot_mask)
+    {
+        if (ss->slots[i] == 0)
+            return i;
+        Counter *c = &ss->counters[ss->slots[i] - 1];
+        if (c->hash == hash && c->len == len && memcmp(c->word, word, len) == 0)
+            return i;
+    }
+}
+
+// Função auxiliar: remove a posição 'i' da tabela, puxando para trás os elementos seguintes da sondagem
+static void remove_slot(spacesaving *ss, size_t i)
+{
+    for (size_t j = (i + 1) & ss->slot_mask; ss->slots[j] != 0; j = (j + 1) & ss->slot_mask)
+    {
+        size_t ideal = (size_t)ss->counters[ss->slots[j] - 1].hash & ss->slot_mask;
+        // O elemento em 'j' pode ocupar 'i' se 'i' estiver entre sua posição ideal e 'j'
+        if (((j - ideal) & ss->slot_mask) >= ((j - i) & ss->slot_mask))
+        {
+            ss->slots[i] = ss->slots[j];
+            i = j;
+        }
+    }
+    ss->slots[i] = 0;
+}
+
+// Função auxiliar: registra a palavra no sketch e retorna sua estimativa (nunca menor que a real)
+static size_t sketch_add(spacesaving *ss, uint64_t hash)
+{
+    uint64_t estimate = UINT64_MAX;
+    uint32_t h1 = (uint32_t)hash, h2 = (uint32_t)(hash >> 32) | 1;
+    for (size_t row = 0; row < COUNTMIN_DEPTH; row++)
+    {
+        uint64_t *cell = &ss->sketch[row * (ss->width_mask + 1) + ((h1 + row * h2) & ss->width_mask)];
+        (*cell)++;
+        if (*cell < estimate)
+            estimate = *cell;
+    }
+    return (size_t)estimate;
+}
+
+// Função auxiliar: garante espaço para uma palavra de 'len' bytes no contador, reaproveitando o buffer
+static bool counter_reserve(Counter *c, size_t len)
+{
+    if (len + 1 > c->capacity)
+    {
+        char *temp = realloc(c->word, len + 1);
+        if (!temp)
+            return false;
+        c->word = temp;
+        c->capacity = len + 1;
+    }
+    return true;
+}
+
+// Função auxiliar: guarda a palavra no contador, reaproveitando o buffer quando possível
+static bool counter_set_word(Counter *c, const char *word, size_t len, uint64_t hash)
+{
+    if (!counter_reserve(c, len))
+        return false;
+    memcpy(c->word, word, len);
+    c->word[len] = '\0';
+    c->len = len;
+    c->hash = hash;
+    return true;
+}
+
+// Função auxiliar: compara dois itens pela estimativa, desempatando pela palavra
+static int item_comp(const void *key, const void *elem)
+{
+    const spacesaving_item *a = (const spacesaving_item *)key;
+    const spacesaving_item *b = (const spacesaving_item *)elem;
+    if (a->count != b->count)
+        return (a->count > b->count) ? 1 : -1;
+    return strcmp(a->word, b->word);
+}
+
+/*-------------------------------------------------------
+   Funções do Space-Saving
+-------------------------------------------------------*/
+
+// Cria uma estrutura Space-Saving que usa aproximadamente 'budget' bytes
+spacesaving *spacesaving_create(size_t budget, bool count_min)
+{
+    spacesaving *ss = calloc(1, sizeof(spacesaving));
+    if (!ss)
+        return NULL;
+
+    size_t counters_budget = count_min ? budget / 2 : budget;
+    ss->capacity = counters_budget / BYTES_PER_COUNTER;
+    if (ss->capacity < MIN_COUNTERS)
+        ss->capacity = MIN_COUNTERS;
+    if (ss->capacity > UINT32_MAX / 2)
+        ss->capacity = UINT32_MAX / 2;
+    ss->slot_mask = floor_pow2(ss->capacity) * 4 - 1; // Ocupação da tabela sempre abaixo de 1/2
+
+    ss->counters = calloc(ss->capacity, sizeof(Counter));
+    ss->heap = malloc(ss->capacity * sizeof(size_t));
+    ss->slots = calloc(ss->slot_mask + 1, sizeof(uint32_t));
+    if (count_min)
+    {
+        size_t width = floor_pow2((budget - counters_budget) / (COUNTMIN_DEPTH * sizeof(uint64_t)) + 1);
+        ss->width_mask = width - 1;
+        ss->sketch = calloc(COUNTMIN_DEPTH * width, sizeof(uint64_t));
+    }
+
+    if (!ss->counters || !ss->heap || !ss->slots || (count_min && !ss->sketch))
+    {
+        spacesaving_free(ss);
+        return NULL;
+    }
+    return ss;
+}
+
+// Registra uma aparição da palavra
+bool spacesaving_add(spacesaving *ss, const char *word, size_t len)
+{
+    uint64_t hash = wordmap_hash(word, len);
+    size_t estimate = ss->sketch ? sketch_add(ss, hash) : SIZE_MAX;
+    size_t slot = find_slot(ss, word, len, hash);
+    ss->total++;
+
+    // Palavra já monitorada: incrementa o contador
+    if (ss->slots[slot] != 0)
+    {
+        Counter *c = &ss->counters[ss->slots[slot] - 1];
+        c->count++;
+        heap_sift_down(ss, c->heap_pos);
+        return true;
+    }
+
+    // Ainda há contadores livres: a contagem é exata
+    if (ss->used < ss->capacity)
+    {
+        Counter *c = &ss->counters[ss->used];
+        if (!counter_set_word(c, word, len, hash))
+            return false;
+        c->count = 1;
+        c->error = 0;
+        c->heap_pos = ss->used;
+        ss->heap[ss->used] = ss->used;
+        ss->slots[slot] = (uint32_t)(++ss->used);
+        heap_sift_up(ss, c->heap_pos);
+        return true;
+    }
+
+    // Substitui o contador de menor estimativa. A palavra nova apareceu no máximo 'evicted' vezes
+    // antes (a contagem que tinha quando deixou de ser monitorada), e o sketch também limita a
+    // contagem por cima. Sem o sketch, 'evicted' é sempre o mínimo atual, como no Space-Saving original.
+    // O buffer cresce antes de a palavra antiga sair da tabela (o realloc a preserva): se faltar
+    // memória, o contador e a tabela continuam como estavam
+    size_t victim = ss->heap[0];
+    Counter *c = &ss->counters[victim];
+    if (!counter_reserve(c, len))
+        return false;
+    if (c->count > ss->evicted)
+        ss->evicted = c->count;
+    remove_slot(ss, find_slot(ss, c->word, c->len, c->hash));
+    counter_set_word(c, word, len, hash);
+    c->count = (estimate < ss->evicted + 1) ? estimate : ss->evicted + 1;
+    c->error = c->count - 1;
+    ss->slots[find_slot(ss, word, len, hash)] = (uint32_t)(victim + 1);
+    heap_sift_down(ss, 0);
+    return true;
+}
+
+// Retorna a quantidade de palavras que a estrutura consegue monitorar
+size_t spacesaving_capacity(spacesaving *ss)
+{
+    return ss->capacity;
+}
+
+// Retorna a quantidade total de palavras registradas
+size_t spacesaving_total(spacesaving *ss)
+{
+    return ss->total;
+}
+
+// Retorna um novo vetor com as 'n' palavras de maior estimativa, da maior para a menor
+dynvec *spacesaving_top(spacesaving *ss, size_t n)
+{
+    dynvec *items = dynvec_create(sizeof(spacesaving_item));
+    if (!items)
+        return NULL;
+    for (size_t i = 0; i < ss->used; i++)
+    {
+        spacesaving_item item = {ss->counters[i].word, ss->counters[i].count, ss->counters[i].error};
+        if (!dynvec_push(items, &item))
+        {
+            dynvec_free(items);
+            return NULL;
+        }
+    }
+    dynvec *top = dynvec_top_k(items, n, item_comp);
+    dynvec_free(items);
+    return top;
+}
+
+// Libera a memória alocada para a estrutura
+void spacesaving_free(spacesaving *ss)
+{
+    if (!ss)
+        return;
+    for (size_t i = 0; ss->counters && i < ss->used; i++)
+        free(ss->counters[i].word);
+    free(ss->counters);
+    free(ss->heap);
+    free(ss->slots);
+    free(ss->sketch);
+    free(ss);
+}
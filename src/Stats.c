@@ -0,0 +1,94 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <Stats.h>
+
+#if STATS_ENABLED
+
+// Nomes dos contadores e das fases no JSON (na ordem dos enums)
+static const char *counter_names[STATS_COUNTERS] = {
+    "tokens", "unique_words", "bytes_read", "comparisons", "swaps", "dynvec_resizes", "allocations"};
+static const char *phase_names[STATS_PHASES] = {
+    "read", "tokenize", "sort", "run_length", "merge", "select", "output"};
+
+_Thread_local uint64_t stats_local[STATS_COUNTERS];
+
+static uint64_t totals[STATS_COUNTERS];        // Contadores somados das threads que já terminaram
+static pthread_mutex_t totals_lock = PTHREAD_MUTEX_INITIALIZER;
+static double phase_start[STATS_PHASES];       // Início da medição atual de cada fase (s)
+static double phase_total[STATS_PHASES];       // Tempo acumulado de cada fase (s)
+
+// Função auxiliar: tempo atual do relógio monotônico em segundos
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+#endif /* STATS_ENABLED */
+
+// Inicia o cronômetro da fase
+void stats_phase_begin(stats_phase phase)
+{
+#if STATS_ENABLED
+    phase_start[phase] = now();
+#else
+    (void)phase;
+#endif
+}
+
+// Para o cronômetro da fase, somando o tempo decorrido ao total da fase
+void stats_phase_end(stats_phase phase)
+{
+#if STATS_ENABLED
+    phase_total[phase] += now() - phase_start[phase];
+#else
+    (void)phase;
+#endif
+}
+
+// Soma os contadores da thread atual aos totais e os zera
+void stats_flush(void)
+{
+#if STATS_ENABLED
+    pthread_mutex_lock(&totals_lock);
+    for (int i = 0; i < STATS_COUNTERS; i++)
+    {
+        totals[i] += stats_local[i];
+        stats_local[i] = 0;
+    }
+    pthread_mutex_unlock(&totals_lock);
+#endif
+}
+
+// Escreve as estatísticas em JSON
+bool stats_print_json(FILE *out)
+{
+#if STATS_ENABLED
+    stats_flush();
+
+    struct rusage usage;
+    long peak_rss = (getrusage(RUSAGE_SELF, &usage) == 0) ? usage.ru_maxrss : -1; // KiB no Linux
+
+    double total = 0;
+    fprintf(out, "{\n  \"phases_ms\": {");
+    for (int i = 0; i < STATS_PHASES; i++)
+    {
+        fprintf(out, "%s\"%s\": %.3f", i ? ", " : "", phase_names[i], phase_total[i] * 1e3);
+        total += phase_total[i];
+    }
+    fprintf(out, "},\n  \"total_ms\": %.3f,\n  \"counters\": {", total * 1e3);
+    for (int i = 0; i < STATS_COUNTERS; i++)
+        fprintf(out, "%s\"%s\": %llu", i ? ", " : "", counter_names[i], (unsigned long long)totals[i]);
+    fprintf(out, "},\n  \"peak_rss_kb\": %ld\n}\n", peak_rss);
+    return true;
+#else
+    (void)out;
+    return false;
+#endif
+}
@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <Stats.h>
+#include <Threadpool.h>
+
+// Tamanho de uma linha de cache: as faixas das threads ficam em linhas separadas
+#define CACHE_LINE 64
+
+// Faixa de blocos de uma thread. O dono e os ladrões retiram blocos do início com o mesmo
+// contador atômico, então cada bloco é executado exatamente uma vez
+typedef struct Range
+{
+    _Alignas(CACHE_LINE) atomic_size_t next; // Próximo bloco da faixa
+    size_t end;                              // Fim (exclusivo) da faixa
+} Range;
+
+// Estrutura que representa o pool de threads
+typedef struct Intthreadpool
+{
+    int threads;         // Quantidade de threads, incluindo a que chama threadpool_run
+    pthread_t *ids;      // Threads criadas pelo pool ('threads' - 1)
+    Range *ranges;       // Faixa de blocos de cada thread
+    pthread_mutex_t run; // Garante uma execução por vez
+
+    pthread_mutex_t lock;                  // Protege os campos abaixo
+    pthread_cond_t start;                  // Sinaliza uma nova execução (ou o fim do pool)
+    pthread_cond_t done;                   // Sinaliza que as threads terminaram a execução
+    unsigned generation;                   // Número da execução atual
+    int pending;                           // Threads que ainda não terminaram a execução atual
+    bool stop;                             // Indica que as threads devem terminar
+    void (*task)(void *ctx, size_t chunk); // Tarefa da execução atual
+    void *ctx;                             // Contexto da tarefa
+} threadpool;
+
+// Argumento de cada thread do pool
+typedef struct Worker
+{
+    threadpool *pool;
+    int id;
+} Worker;
+
+// Pool da tarefa que a thread atual está executando (NULL fora de uma tarefa)
+static _Thread_local threadpool *current_pool;
+
+/*-------------------------------------------------------
+   Funções auxiliares
+-------------------------------------------------------*/
+
+// Função auxiliar: executa os blocos da faixa da thread 'id' e depois rouba os das outras faixas
+static void work(threadpool *pool, int id)
+{
+    threadpool *outer = current_pool;
+    current_pool = pool;
+    for (int i = 0; i < pool->threads; i++)
+    {
+        Range *range = &pool->ranges[(id + i) % pool->threads];
+        size_t chunk;
+        while ((chunk = atomic_fetch_add_explicit(&range->next, 1, memory_order_relaxed)) < range->end)
+            pool->task(pool->ctx, chunk);
+    }
+    current_pool = outer;
+}
+
+// Função auxiliar: laço de uma thread do pool, que espera cada execução e participa dela
+static void *worker_loop(void *arg)
+{
+    Worker *worker = (Worker *)arg;
+    threadpool *pool = worker->pool;
+    int id = worker->id;
+    free(worker);
+
+    unsigned seen = 0;
+    for (;;)
+    {
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->stop && pool->generation == seen)
+            pthread_cond_wait(&pool->start, &pool->lock);
+        if (pool->stop)
+        {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        work(pool, id);
+
+        // Os contadores são por thread: são somados antes de avisar o fim da execução
+        STATS_FLUSH();
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0)
+            pthread_cond_signal(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return NULL;
+}
+
+/*-------------------------------------------------------
+   Funções do pool de threads
+-------------------------------------------------------*/
+
+// Cria um pool com 'threads' threads (incluindo a que chama threadpool_run)
+threadpool *threadpool_create(int threads)
+{
+    if (threads < 1)
+        threads = 1;
+    threadpool *pool = calloc(1, sizeof(threadpool));
+    if (!pool)
+        return NULL;
+    pool->threads = threads;
+    pool->ids = malloc(threads * sizeof(pthread_t));
+    pool->ranges = aligned_alloc(CACHE_LINE, threads * sizeof(Range));
+    if (!pool->ids || !pool->ranges)
+    {
+        free(pool->ids);
+        free(pool->ranges);
+        free(pool);
+        return NULL;
+    }
+    for (int i = 0; i < threads; i++)
+    {
+        atomic_init(&pool->ranges[i].next, 0);
+        pool->ranges[i].end = 0;
+    }
+    pthread_mutex_init(&pool->run, NULL);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    // Se alguma thread não puder ser criada, o pool fica com as que já foram criadas
+    int created = 0;
+    for (int i = 1; i < threads; i++)
+    {
+        Worker *worker = malloc(sizeof(Worker));
+        if (!worker)
+            break;
+        *worker = (Worker){pool, i};
+        if (pthread_create(&pool->ids[created], NULL, worker_loop, worker) != 0)
+        {
+            free(worker);
+            break;
+        }
+        created++;
+    }
+    pool->threads = created + 1;
+    if (created == 0 && threads > 1)
+    {
+        threadpool_free(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+// Retorna a quantidade de threads do pool
+int threadpool_threads(threadpool *pool)
+{
+    return pool->threads;
+}
+
+// Executa a tarefa para cada bloco, dividindo os blocos entre as threads com roubo de trabalho
+void threadpool_run(threadpool *pool, size_t chunks, void (*task)(void *ctx, size_t chunk), void *ctx)
+{
+    // Dentro de uma tarefa do próprio pool (ou sem threads extras), os blocos rodam na thread atual
+    if (current_pool == pool || pool->threads == 1 || chunks <= 1)
+    {
+        for (size_t chunk = 0; chunk < chunks; chunk++)
+            task(ctx, chunk);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->run);
+    for (int i = 0; i < pool->threads; i++)
+    {
+        atomic_store_explicit(&pool->ranges[i].next, chunks * i / pool->threads, memory_order_relaxed);
+        pool->ranges[i].end = chunks * (i + 1) / pool->threads;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->ctx = ctx;
+    pool->pending = pool->threads - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    work(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0)
+        pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+    pthread_mutex_unlock(&pool->run);
+}
+
+// Termina as threads e libera a memória do pool
+void threadpool_free(threadpool *pool)
+{
+    if (!pool)
+        return;
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->threads - 1; i++)
+        pthread_join(pool->ids[i], NULL);
+
+    pthread_mutex_destroy(&pool->run);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+    free(pool->ids);
+    free(pool->ranges);
+    free(pool);
+}
@@ -0,0 +1,608 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <Stats.h>
+#include <Gzstream.h>
+#include <Tokenizer.h>
+#include <TokenizerTables.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TOKENIZER_X86 1
+#endif
+
+// Modos de leitura do tokenizador
+typedef enum Source
+{
+    SOURCE_MMAP,   // Arquivo inteiro mapeado em memória
+    SOURCE_BLOCKS, // Arquivo lido em blocos para um buffer próprio
+    SOURCE_BUFFER  // Buffer fornecido pelo usuário
+} source;
+
+// Estrutura que representa o tokenizador
+typedef struct Inttokenizer
+{
+    source mode;       // Modo de leitura
+    int fd;            // Descritor do arquivo (-1 se não houver)
+    bool owns_fd;      // Indica se o descritor deve ser fechado pelo tokenizador
+    char *data;        // Início dos dados disponíveis (mapeamento ou buffer)
+    size_t size;       // Quantidade de bytes válidos em 'data'
+    size_t capacity;   // Capacidade do buffer próprio (leitura em blocos)
+    size_t pos;        // Posição atual da leitura em 'data'
+    bool eof;          // Indica que não há mais bytes a serem lidos do arquivo
+    bool error;        // Indica que ocorreu um erro de leitura
+    bool fold;         // Normaliza as palavras (--fold)
+    unsigned state;    // Estado do autômato de normalização (preservado entre os blocos)
+    char *word;        // Palavra normalizada
+    size_t word_len;   // Tamanho da palavra normalizada
+    size_t word_cap;   // Capacidade do buffer da palavra normalizada
+    gzstream *gz;      // Descompressão do arquivo (NULL se ele não é comprimido com gzip)
+} tokenizer;
+
+// Normalização usada pelos tokenizadores criados a partir de agora
+static bool fold_default = false;
+
+// Bytes lidos por vez na normalização, com o espaço da palavra reservado uma vez por janela
+#define FOLD_WINDOW 4096
+
+/*-------------------------------------------------------
+   Funções auxiliares
+-------------------------------------------------------*/
+
+// Verifica se o byte faz parte de uma palavra: letra ASCII ou byte de um caractere acentuado (>= 128)
+static inline bool is_word_byte(unsigned char ch)
+{
+    return (unsigned char)((ch | 0x20) - 'a') < 26 || ch >= 128;
+}
+
+/*-------------------------------------------------------
+   Núcleos de classificação de bytes
+-------------------------------------------------------*/
+
+// Núcleo de varredura: a partir de 'pos', retorna a posição do primeiro byte que
+// inicia (skip_delims) ou termina (skip_word) uma palavra, ou 'size' se não houver
+typedef size_t (*scan_fn)(const unsigned char *data, size_t pos, size_t size);
+
+// Versão escalar: pula os separadores, um byte por vez
+static size_t skip_delims_scalar(const unsigned char *data, size_t pos, size_t size)
+{
+    while (pos < size && !is_word_byte(data[pos]))
+        pos++;
+    return pos;
+}
+
+// Versão escalar: avança até o fim da palavra, um byte por vez
+static size_t skip_word_scalar(const unsigned char *data, size_t pos, size_t size)
+{
+    while (pos < size && is_word_byte(data[pos]))
+        pos++;
+    return pos;
+}
+
+#ifdef TOKENIZER_X86
+/*
+ * Máscara de bytes de palavra em 16 bytes: letras ASCII ((ch | 0x20) - 'a' < 26, feito com
+ * comparação com sinal após somar 0x80 - 'a') ou qualquer byte >= 128, o que inclui tanto os
+ * bytes iniciais quanto os de continuação dos caracteres UTF-8.
+ */
+static inline unsigned word_mask_sse2(const unsigned char *p)
+{
+    __m128i v = _mm_loadu_si128((const __m128i *)p);
+    __m128i shifted = _mm_add_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)), _mm_set1_epi8((char)(0x80 - 'a')));
+    __m128i letters = _mm_cmpgt_epi8(_mm_set1_epi8((char)(-128 + 26)), shifted);
+    return (unsigned)(_mm_movemask_epi8(letters) | _mm_movemask_epi8(v));
+}
+
+// Versão SSE2: pula os separadores, 16 bytes por vez
+static size_t skip_delims_sse2(const unsigned char *data, size_t pos, size_t size)
+{
+    for (; pos + 16 <= size; pos += 16)
+    {
+        unsigned mask = word_mask_sse2(data + pos);
+        if (mask)
+            return pos + __builtin_ctz(mask);
+    }
+    return skip_delims_scalar(data, pos, size);
+}
+
+// Versão SSE2: avança até o fim da palavra, 16 bytes por vez
+static size_t skip_word_sse2(const unsigned char *data, size_t pos, size_t size)
+{
+    for (; pos + 16 <= size; pos += 16)
+    {
+        unsigned mask = ~word_mask_sse2(data + pos) & 0xffffu;
+        if (mask)
+            return pos + __builtin_ctz(mask);
+    }
+    return skip_word_scalar(data, pos, size);
+}
+
+// Mesma classificação da versão SSE2, mas com 32 bytes por vez
+__attribute__((target("avx2"))) static inline unsigned word_mask_avx2(const unsigned char *p)
+{
+    __m256i v = _mm256_loadu_si256((const __m256i *)p);
+    __m256i shifted = _mm256_add_epi8(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), _mm256_set1_epi8((char)(0x80 - 'a')));
+    __m256i letters = _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(-128 + 26)), shifted);
+    return (unsigned)(_mm256_movemask_epi8(letters) | _mm256_movemask_epi8(v));
+}
+
+// Versão AVX2: pula os separadores, 32 bytes por vez
+__attribute__((target("avx2"))) static size_t skip_delims_avx2(const unsigned char *data, size_t pos, size_t size)
+{
+    for (; pos + 32 <= size; pos += 32)
+    {
+        unsigned mask = word_mask_avx2(data + pos);
+        if (mask)
+            return pos + __builtin_ctz(mask);
+    }
+    return skip_delims_sse2(data, pos, size);
+}
+
+// Versão AVX2: avança até o fim da palavra, 32 bytes por vez
+__attribute__((target("avx2"))) static size_t skip_word_avx2(const unsigned char *data, size_t pos, size_t size)
+{
+    for (; pos + 32 <= size; pos += 32)
+    {
+        unsigned mask = ~word_mask_avx2(data + pos);
+        if (mask)
+            return pos + __builtin_ctz(mask);
+    }
+    return skip_word_sse2(data, pos, size);
+}
+#endif
+
+// Núcleo em uso, escolhido na inicialização do programa
+static scan_fn skip_delims = skip_delims_scalar;
+static scan_fn skip_word = skip_word_scalar;
+static const char *kernel_name = "scalar";
+
+// Escolhe o núcleo mais rápido suportado pelo processador
+__attribute__((constructor)) static void select_kernel(void)
+{
+#ifdef TOKENIZER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        tokenizer_set_kernel("avx2");
+    else if (__builtin_cpu_supports("sse2"))
+        tokenizer_set_kernel("sse2");
+#endif
+}
+
+// Função auxiliar: cria o tokenizador com os campos zerados
+static tokenizer *tokenizer_alloc(source mode, int fd, bool owns_fd)
+{
+    tokenizer *tk = calloc(1, sizeof(tokenizer));
+    if (!tk)
+        return NULL;
+    tk->mode = mode;
+    tk->fd = fd;
+    tk->owns_fd = owns_fd;
+    tk->fold = fold_default;
+    return tk;
+}
+
+// Função auxiliar: descarta os bytes antes de 'keep', move o restante para o início do buffer e lê mais um bloco.
+// Retorna false quando não há mais nada a ser lido.
+static bool refill(tokenizer *tk, size_t keep)
+{
+    if (tk->eof)
+        return false;
+
+    size_t kept = tk->size - keep;
+    memmove(tk->data, tk->data + keep, kept);
+    tk->size = kept;
+    tk->pos -= keep;
+
+    // Uma palavra que ocupa o buffer inteiro exige um buffer maior
+    if (tk->size == tk->capacity)
+    {
+        char *temp = realloc(tk->data, tk->capacity * 2);
+        if (!temp)
+        {
+            tk->error = true;
+            tk->eof = true;
+            return false;
+        }
+        tk->data = temp;
+        tk->capacity *= 2;
+    }
+
+    ssize_t got;
+    do
+        got = tk->gz ? gzstream_read(tk->gz, tk->data + tk->size, tk->capacity - tk->size)
+                     : read(tk->fd, tk->data + tk->size, tk->capacity - tk->size);
+    while (got < 0 && errno == EINTR);
+
+    if (got <= 0)
+    {
+        tk->error = (got < 0);
+        tk->eof = true;
+        return false;
+    }
+    tk->size += (size_t)got;
+    STATS_ADD(STATS_BYTES_READ, got);
+    return true;
+}
+
+/*-------------------------------------------------------
+   Funções do tokenizador
+-------------------------------------------------------*/
+
+// Função auxiliar: cria um tokenizador que lê o descritor 'fd' em blocos, sem verificar se ele é gzip
+static tokenizer *open_blocks(int fd)
+{
+    tokenizer *tk = tokenizer_alloc(SOURCE_BLOCKS, fd, false);
+    if (!tk)
+        return NULL;
+
+    // O buffer é alinhado à página para que o kernel copie blocos inteiros
+    tk->capacity = TOKENIZER_BLOCK_SIZE;
+    if (posix_memalign((void **)&tk->data, 4096, tk->capacity) != 0)
+    {
+        free(tk);
+        return NULL;
+    }
+    return tk;
+}
+
+// Cria um tokenizador que lê o descritor 'fd' em blocos, descomprimindo a entrada se ela for gzip
+tokenizer *tokenizer_open_fd(int fd)
+{
+    tokenizer *tk = open_blocks(fd);
+    if (!tk)
+        return NULL;
+
+    // Os primeiros bytes são lidos com read (pipes não permitem pread) e viram o começo do
+    // buffer, ou o começo da entrada comprimida se tiverem a assinatura do gzip
+    size_t size = 0;
+    while (size < 2)
+    {
+        ssize_t got = read(fd, tk->data + size, 2 - size);
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got <= 0)
+        {
+            tk->error = (got < 0);
+            tk->eof = true;
+            break;
+        }
+        size += (size_t)got;
+    }
+    if (size == 2 && (unsigned char)tk->data[0] == 0x1f && (unsigned char)tk->data[1] == 0x8b)
+    {
+        tk->gz = gzstream_open(fd, tk->data, size);
+        if (!tk->gz)
+        {
+            tokenizer_close(tk);
+            return NULL;
+        }
+        return tk;
+    }
+    tk->size = size;
+    STATS_ADD(STATS_BYTES_READ, size);
+    return tk;
+}
+
+// Função auxiliar: lê em blocos o arquivo gzip aberto em 'fd', descomprimido por outra thread.
+// O descritor passa a ser do tokenizador (e é fechado em caso de erro)
+static tokenizer *open_gzip(int fd)
+{
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    tokenizer *tk = open_blocks(fd);
+    if (!tk)
+    {
+        close(fd);
+        return NULL;
+    }
+    tk->owns_fd = true;
+    tk->gz = gzstream_open(fd, NULL, 0);
+    if (!tk->gz)
+    {
+        tokenizer_close(tk);
+        return NULL;
+    }
+    return tk;
+}
+
+// Abre o arquivo e o mapeia em memória; caso não seja possível, lê em blocos
+tokenizer *tokenizer_open(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+    if (gzstream_detect(fd))
+        return open_gzip(fd);
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+    {
+        tokenizer *tk = tokenizer_alloc(SOURCE_MMAP, fd, true);
+        if (!tk)
+        {
+            close(fd);
+            return NULL;
+        }
+        tk->eof = true;
+        tk->size = (size_t)st.st_size;
+        if (tk->size == 0) // Arquivo vazio: não há nada para mapear
+            return tk;
+
+        void *map = mmap(NULL, tk->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED)
+        {
+            madvise(map, tk->size, MADV_SEQUENTIAL);
+            tk->data = map;
+            STATS_ADD(STATS_BYTES_READ, tk->size);
+            return tk;
+        }
+        free(tk);
+    }
+
+    tokenizer *tk = open_blocks(fd);
+    if (!tk)
+    {
+        close(fd);
+        return NULL;
+    }
+    tk->owns_fd = true;
+    return tk;
+}
+
+// Abre o arquivo para ser lido em blocos, sem mapeá-lo
+tokenizer *tokenizer_open_blocks(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+    if (gzstream_detect(fd))
+        return open_gzip(fd);
+    tokenizer *tk = open_blocks(fd);
+    if (!tk)
+    {
+        close(fd);
+        return NULL;
+    }
+    tk->owns_fd = true;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    return tk;
+}
+
+// Cria um tokenizador sobre um buffer já carregado em memória
+tokenizer *tokenizer_open_buffer(const char *data, size_t size)
+{
+    tokenizer *tk = tokenizer_alloc(SOURCE_BUFFER, -1, false);
+    if (!tk)
+        return NULL;
+    tk->data = (char *)data;
+    tk->size = size;
+    tk->eof = true;
+    return tk;
+}
+
+// Função auxiliar: garante espaço para 'needed' bytes na palavra normalizada
+static bool reserve_word(tokenizer *tk, size_t needed)
+{
+    if (needed <= tk->word_cap)
+        return true;
+    size_t capacity = tk->word_cap ? tk->word_cap * 2 : 64;
+    if (capacity < needed)
+        capacity = needed;
+    char *temp = realloc(tk->word, capacity);
+    if (!temp)
+        return false;
+    tk->word = temp;
+    tk->word_cap = capacity;
+    return true;
+}
+
+// Função auxiliar: próxima palavra com normalização. Percorre a entrada uma única vez com o
+// autômato de obj/TokenizerTables.h, que decodifica o UTF-8, separa as palavras e converte as
+// letras para minúsculas, escrevendo a palavra normalizada direto no buffer do tokenizador.
+static bool next_folded(tokenizer *tk, token *tok)
+{
+    unsigned state = tk->state;
+    size_t len = tk->word_len;
+    for (;;)
+    {
+        const unsigned char *data = (const unsigned char *)tk->data;
+        size_t pos = tk->pos, size = tk->size;
+        while (pos < size)
+        {
+            // Cada byte lido acrescenta no máximo um byte à palavra (o 0xC3 de uma letra Latin-1 só é
+            // escrito junto com o segundo byte): o espaço é reservado uma vez para a janela inteira
+            size_t end = (size - pos > FOLD_WINDOW) ? pos + FOLD_WINDOW : size;
+            if (!reserve_word(tk, len + (end - pos) + 1))
+            {
+                tk->error = true;
+                return false;
+            }
+            char *word = tk->word;
+            while (pos < end)
+            {
+                unsigned byte = data[pos];
+                unsigned entry = fold_next[state][fold_class[byte]];
+                state = entry & FOLD_STATE_MASK;
+                switch (entry >> FOLD_STATE_BITS)
+                {
+                case FOLD_NONE:
+                    pos++;
+                    break;
+                case FOLD_APPEND_LATIN1:
+                    word[len++] = (char)0xC3;
+                    /* fall through */
+                case FOLD_APPEND:
+                    word[len++] = (char)fold_byte[byte];
+                    pos++;
+                    // Atalho para o caso mais comum: as letras ASCII seguintes continuam a palavra
+                    while (pos < end && fold_class[data[pos]] == FOLD_LETTER)
+                        word[len++] = (char)fold_byte[data[pos++]];
+                    break;
+                case FOLD_END:
+                    pos++;
+                    /* fall through */
+                default: // FOLD_END_KEEP
+                    tk->pos = pos;
+                    tk->state = state;
+                    tk->word_len = 0;
+                    tok->ptr = word;
+                    tok->len = len;
+                    STATS_INC(STATS_TOKENS);
+                    return true;
+                }
+            }
+        }
+        tk->pos = pos;
+
+        // Os bytes lidos já estão na palavra normalizada: o bloco inteiro pode ser descartado
+        tk->word_len = len;
+        if (!refill(tk, tk->size))
+        {
+            // Fim da entrada no meio de uma palavra (um 0xC3 pendente é descartado)
+            tk->state = FOLD_OUT;
+            tk->word_len = 0;
+            if (len == 0)
+                return false;
+            tok->ptr = tk->word;
+            tok->len = len;
+            STATS_INC(STATS_TOKENS);
+            return true;
+        }
+    }
+}
+
+// Guarda em 'tok' a próxima palavra; retorna false quando a entrada termina
+bool tokenizer_next(tokenizer *tk, token *tok)
+{
+    if (tk->fold)
+        return next_folded(tk, tok);
+
+    for (;;)
+    {
+        const unsigned char *data = (const unsigned char *)tk->data;
+
+        // Pula os separadores até o início da próxima palavra
+        tk->pos = skip_delims(data, tk->pos, tk->size);
+
+        if (tk->pos == tk->size)
+        {
+            if (!refill(tk, tk->size))
+                return false;
+            continue;
+        }
+
+        // Avança até o fim da palavra
+        size_t start = tk->pos;
+        tk->pos = skip_word(data, tk->pos, tk->size);
+
+        // A palavra pode continuar no próximo bloco: preserva seu início, lê mais e a percorre de novo
+        if (tk->pos == tk->size && !tk->eof)
+        {
+            tk->pos = start;
+            refill(tk, start);
+            continue;
+        }
+
+        tok->ptr = tk->data + start;
+        tok->len = tk->pos - start;
+        STATS_INC(STATS_TOKENS);
+        return true;
+    }
+}
+
+// Retorna o conteúdo inteiro da entrada, quando ele está disponível em memória
+const char *tokenizer_buffer(tokenizer *tk, size_t *size)
+{
+    if (tk->mode == SOURCE_BLOCKS)
+        return NULL;
+    *size = tk->size;
+    return tk->data ? tk->data : ""; // Arquivo vazio: não foi mapeado, mas está inteiro em memória
+}
+
+// Ajusta 'pos' para a primeira posição, a partir dela, que não está no meio de uma palavra
+size_t tokenizer_boundary(const char *data, size_t size, size_t pos)
+{
+    if (pos == 0 || pos >= size)
+        return (pos > size) ? size : pos;
+    // Se o byte anterior é separador, 'pos' já inicia uma palavra (ou um trecho de separadores)
+    if (!is_word_byte((unsigned char)data[pos - 1]))
+        return pos;
+    return skip_word((const unsigned char *)data, pos, size);
+}
+
+// Retorna a posição onde começa a última palavra de 'data', que pode continuar nos próximos bytes
+size_t tokenizer_word_start(const char *data, size_t size)
+{
+    // Os bytes de palavra da normalização também são bytes de palavra aqui: a posição serve aos dois modos
+    while (size > 0 && is_word_byte((unsigned char)data[size - 1]))
+        size--;
+    return size;
+}
+
+// Escolhe o núcleo de classificação ("scalar", "sse2" ou "avx2"); retorna false se não for suportado
+bool tokenizer_set_kernel(const char *name)
+{
+    if (strcmp(name, "scalar") == 0)
+    {
+        skip_delims = skip_delims_scalar;
+        skip_word = skip_word_scalar;
+        kernel_name = "scalar";
+    }
+#ifdef TOKENIZER_X86
+    else if (strcmp(name, "sse2") == 0 && __builtin_cpu_supports("sse2"))
+    {
+        skip_delims = skip_delims_sse2;
+        skip_word = skip_word_sse2;
+        kernel_name = "sse2";
+    }
+    else if (strcmp(name, "avx2") == 0 && __builtin_cpu_supports("avx2"))
+    {
+        skip_delims = skip_delims_avx2;
+        skip_word = skip_word_avx2;
+        kernel_name = "avx2";
+    }
+#endif
+    else
+        return false;
+    return true;
+}
+
+// Retorna o nome do núcleo de classificação em uso
+const char *tokenizer_kernel(void)
+{
+    return kernel_name;
+}
+
+// Ativa ou desativa a normalização nos tokenizadores criados a partir de agora
+void tokenizer_set_fold(bool fold)
+{
+    fold_default = fold;
+}
+
+// Retorna true caso tenha ocorrido um erro de leitura
+bool tokenizer_error(tokenizer *tk)
+{
+    return tk->error;
+}
+
+// Fecha o arquivo e libera a memória do tokenizador
+void tokenizer_close(tokenizer *tk)
+{
+    if (!tk)
+        return;
+    if (tk->mode == SOURCE_MMAP && tk->data)
+        munmap(tk->data, tk->size);
+    else if (tk->mode == SOURCE_BLOCKS)
+        free(tk->data);
+    gzstream_close(tk->gz);
+    if (tk->owns_fd)
+        close(tk->fd);
+    free(tk->word);
+    free(tk);
+}
@@ -0,0 +1,277 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <GenericDynvec.h>
+#include <Wordmap.h>
+#include <Wordlookup.h>
+#include <Wordindex.h>
+
+// Estrutura que representa um índice aberto (somente leitura, mapeado em memória)
+typedef struct Intwordindex
+{
+    const char *data;                 // Início do mapeamento
+    size_t size;                      // Tamanho do arquivo
+    const wordindex_header *header;   // Cabeçalho
+    const wordindex_record *ranking;  // Seção do ranking
+    const wordlookup_node *lookup;    // Seção de busca (layout Eytzinger)
+    const char *words;                // Seção das palavras
+} wordindex;
+
+// Palavra da seção de busca durante a escrita
+typedef struct LookupItem
+{
+    const char *word; // Palavra (handle da tabela)
+    size_t len;       // Tamanho da palavra
+    uint32_t rank;    // Posição da palavra no ranking
+    uint32_t offset;  // Deslocamento da palavra na seção das palavras
+} LookupItem;
+
+/*-------------------------------------------------------
+   Funções auxiliares
+-------------------------------------------------------*/
+
+// Função auxiliar: arredonda 'offset' para o próximo múltiplo de 'alignment' (potência de 2)
+static inline uint64_t align_to(uint64_t offset, uint64_t alignment)
+{
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+// Função auxiliar: compara dois itens da seção de busca pela palavra
+static int lookup_comp(const void *key, const void *elem)
+{
+    return strcmp(((const LookupItem *)key)->word, ((const LookupItem *)elem)->word);
+}
+
+// Função auxiliar: grava 'size' bytes de zeros para alinhar a próxima seção
+static bool write_padding(FILE *file, size_t size)
+{
+    static const char zeros[WORDINDEX_LOOKUP_ALIGN] = {0};
+    return size == 0 || fwrite(zeros, 1, size, file) == size;
+}
+
+// Função auxiliar: grava as seções do índice em 'file'. 'ranked' tem as entradas da mais usada para a menos usada
+static bool write_sections(FILE *file, dynvec *ranked, size_t total)
+{
+    size_t length = dynvec_length(ranked);
+    wordindex_header header = {{0}, WORDINDEX_VERSION, sizeof(wordindex_header), length, total, 0, 0, 0, 0};
+    memcpy(header.magic, WORDINDEX_MAGIC, sizeof(header.magic));
+    header.ranking_offset = sizeof(wordindex_header);
+    header.lookup_offset = align_to(header.ranking_offset + length * sizeof(wordindex_record), WORDINDEX_LOOKUP_ALIGN);
+    header.words_offset = header.lookup_offset + (length + 1) * sizeof(wordlookup_node);
+    for (size_t i = 0; i < length; i++)
+        header.words_size += ((wordmap_entry *)dynvec_get(ranked, i))->len + 1;
+    // Os nós da busca guardam o deslocamento das palavras em 32 bits
+    if (header.words_size > UINT32_MAX)
+    {
+        errno = EOVERFLOW;
+        return false;
+    }
+
+    if (fwrite(&header, sizeof(header), 1, file) != 1)
+        return false;
+
+    // Ranking: as palavras ficam na seção das palavras na mesma ordem
+    dynvec *lookup = dynvec_create(sizeof(LookupItem));
+    bool ok = lookup != NULL;
+    uint64_t offset = 0;
+    for (size_t i = 0; ok && i < length; i++)
+    {
+        wordmap_entry *entry = (wordmap_entry *)dynvec_get(ranked, i);
+        wordindex_record record = {entry->times, offset};
+        LookupItem item = {entry->word, entry->len, (uint32_t)i, (uint32_t)offset};
+        ok = fwrite(&record, sizeof(record), 1, file) == 1 && dynvec_push(lookup, &item);
+        offset += entry->len + 1;
+    }
+    if (!ok || !write_padding(file, header.lookup_offset - (header.ranking_offset + length * sizeof(wordindex_record))))
+    {
+        dynvec_free(lookup);
+        return false;
+    }
+
+    // Busca: as palavras em ordem alfabética, reorganizadas no layout Eytzinger
+    if (length > 1)
+        quicksort_dynvec_three_way(lookup, lookup_comp, 0, length - 1);
+    wordlookup_node *sorted = malloc((length + 1) * sizeof(wordlookup_node));
+    wordlookup_node *nodes = malloc((length + 1) * sizeof(wordlookup_node));
+    ok = sorted && nodes;
+    for (size_t i = 0; ok && i < length; i++)
+    {
+        LookupItem *item = (LookupItem *)dynvec_get(lookup, i);
+        sorted[i] = (wordlookup_node){wordlookup_prefix(item->word, item->len), item->offset, item->rank};
+    }
+    if (ok)
+    {
+        wordlookup_layout(nodes, sorted, length);
+        ok = fwrite(nodes, sizeof(wordlookup_node), length + 1, file) == length + 1;
+    }
+    free(sorted);
+    free(nodes);
+    dynvec_free(lookup);
+    if (!ok)
+        return false;
+
+    // Palavras, cada uma com o seu '\0'
+    for (size_t i = 0; i < length; i++)
+    {
+        wordmap_entry *entry = (wordmap_entry *)dynvec_get(ranked, i);
+        if (fwrite(entry->word, 1, entry->len + 1, file) != entry->len + 1)
+            return false;
+    }
+    return true;
+}
+
+/*-------------------------------------------------------
+   Funções do índice de palavras
+-------------------------------------------------------*/
+
+// Grava em 'path' o índice com todas as palavras da tabela
+bool wordindex_write(const char *path, wordmap *map)
+{
+    dynvec *entries = wordmap_entries(map);
+    size_t length = dynvec_length(entries);
+    if (length > UINT32_MAX)
+    {
+        errno = EOVERFLOW;
+        return false;
+    }
+
+    // Todas as entradas, da mais usada para a menos usada
+    dynvec *ranked = dynvec_top_k(entries, length, wordmap_rank_comp);
+    if (!ranked)
+        return false;
+    size_t total = 0;
+    for (size_t i = 0; i < length; i++)
+        total += ((wordmap_entry *)dynvec_get(entries, i))->times;
+
+    size_t path_len = strlen(path);
+    char *temp_path = malloc(path_len + 5);
+    if (!temp_path)
+    {
+        dynvec_free(ranked);
+        return false;
+    }
+    memcpy(temp_path, path, path_len);
+    memcpy(temp_path + path_len, ".tmp", 5);
+
+    FILE *file = fopen(temp_path, "wb");
+    bool ok = file != NULL && write_sections(file, ranked, total);
+    if (file)
+        ok = (fclose(file) == 0) && ok;
+    ok = ok && rename(temp_path, path) == 0;
+    if (!ok && file)
+    {
+        int saved = errno;
+        remove(temp_path);
+        errno = saved;
+    }
+
+    free(temp_path);
+    dynvec_free(ranked);
+    return ok;
+}
+
+// Abre e mapeia em memória o índice 'path', validando o cabeçalho e os limites das seções
+wordindex *wordindex_open(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+
+    struct stat st;
+    void *data = MAP_FAILED;
+    bool too_small = false;
+    if (fstat(fd, &st) == 0)
+    {
+        too_small = (size_t)st.st_size < sizeof(wordindex_header);
+        if (!too_small)
+            data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    int saved = errno;
+    close(fd); // O mapeamento continua válido sem o descritor
+    if (data == MAP_FAILED)
+    {
+        errno = too_small ? EINVAL : saved;
+        return NULL;
+    }
+
+    size_t size = (size_t)st.st_size;
+    const wordindex_header *header = (const wordindex_header *)data;
+    uint64_t length = header->length;
+    bool valid = memcmp(header->magic, WORDINDEX_MAGIC, sizeof(header->magic)) == 0 &&
+                 header->version == WORDINDEX_VERSION &&
+                 header->header_size == sizeof(wordindex_header) &&
+                 length <= UINT32_MAX &&
+                 header->ranking_offset % 8 == 0 && header->words_offset <= size &&
+                 header->ranking_offset <= size && length * sizeof(wordindex_record) <= size - header->ranking_offset &&
+                 header->lookup_offset % WORDINDEX_LOOKUP_ALIGN == 0 &&
+                 header->lookup_offset <= size && (length + 1) * sizeof(wordlookup_node) <= size - header->lookup_offset &&
+                 header->words_size <= size - header->words_offset &&
+                 (header->words_size == 0 ? length == 0 : ((const char *)data)[header->words_offset + header->words_size - 1] == '\0');
+
+    wordindex *ix = valid ? malloc(sizeof(wordindex)) : NULL;
+    if (!ix)
+    {
+        munmap(data, size);
+        if (!valid)
+            errno = EINVAL;
+        return NULL;
+    }
+
+    ix->data = (const char *)data;
+    ix->size = size;
+    ix->header = header;
+    ix->ranking = (const wordindex_record *)(ix->data + header->ranking_offset);
+    ix->lookup = (const wordlookup_node *)(ix->data + header->lookup_offset);
+    ix->words = ix->data + header->words_offset;
+    return ix;
+}
+
+// Retorna a quantidade de palavras distintas do índice
+size_t wordindex_length(wordindex *ix)
+{
+    return (size_t)ix->header->length;
+}
+
+// Retorna a quantidade total de palavras do texto indexado
+size_t wordindex_total(wordindex *ix)
+{
+    return (size_t)ix->header->total;
+}
+
+// Retorna a palavra na posição 'rank' do ranking e guarda suas aparições em 'times'
+const char *wordindex_word(wordindex *ix, size_t rank, size_t *times)
+{
+    if (rank >= ix->header->length || ix->ranking[rank].word >= ix->header->words_size)
+        return NULL;
+    if (times)
+        *times = (size_t)ix->ranking[rank].times;
+    return ix->words + ix->ranking[rank].word;
+}
+
+// Retorna a quantidade de aparições da palavra, com a busca em layout Eytzinger da seção de busca
+size_t wordindex_count(wordindex *ix, const char *word, size_t len)
+{
+    size_t rank = wordlookup_find(ix->lookup, (size_t)ix->header->length, ix->words,
+                                  (size_t)ix->header->words_size, word, len);
+    size_t times = 0;
+    if (rank != WORDLOOKUP_NOT_FOUND)
+        wordindex_word(ix, rank, &times);
+    return times;
+}
+
+// Desfaz o mapeamento e libera a memória do índice
+void wordindex_close(wordindex *ix)
+{
+    if (ix)
+    {
+        munmap((void *)ix->data, ix->size);
+        free(ix);
+    }
+}
@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <GenericDynvec.h>
+#include <Arena.h>
+#include <Wordmap.h>
+#include <Wordlookup.h>
+
+// Tamanho de uma linha de cache; o vetor de nós é alinhado a ela
+#define CACHE_LINE 64
+
+// Estrutura que representa a busca de palavras em memória
+typedef struct Intwordlookup
+{
+    wordlookup_node *nodes; // Nós em layout Eytzinger ('length + 1' posições)
+    size_t length;          // Quantidade de palavras
+    char *words;            // Bloco com as palavras, em ordem alfabética, cada uma terminada em '\0'
+    size_t words_size;      // Tamanho do bloco de palavras
+    size_t *times;          // Aparições de cada palavra, indexadas pelo 'id' do nó
+} wordlookup;
+
+/*-------------------------------------------------------
+   Funções auxiliares
+-------------------------------------------------------*/
+
+// Função auxiliar: compara o restante (após os 8 bytes do prefixo) da palavra com 'len' bytes
+// com o restante da palavra do nó. Só é chamada quando os prefixos são iguais e 'len' >= 8.
+static inline int tail_comp(const wordlookup_node *node, const char *words, size_t words_size,
+                            const char *word, size_t len)
+{
+    // Um deslocamento inválido (arquivo corrompido) nunca é lido: o nó é tratado como menor
+    if ((size_t)node->word + 8 >= words_size)
+        return 1;
+    const char *tail = words + node->word + 8;
+    int comp = strncmp(word + 8, tail, len - 8);
+    if (comp != 0)
+        return comp;
+    return tail[len - 8] == '\0' ? 0 : -1;
+}
+
+// Função auxiliar: percorre em ordem a árvore implícita com raiz em 'k', atribuindo a cada
+// posição o próximo nó de 'sorted'. Retorna o índice do próximo nó a ser usado.
+static size_t layout_rec(wordlookup_node *nodes, const wordlookup_node *sorted, size_t length, size_t i, size_t k)
+{
+    if (k <= length)
+    {
+        i = layout_rec(nodes, sorted, length, i, 2 * k);
+        nodes[k] = sorted[i++];
+        i = layout_rec(nodes, sorted, length, i, 2 * k + 1);
+    }
+    return i;
+}
+
+/*-------------------------------------------------------
+   Funções da busca de palavras
+-------------------------------------------------------*/
+
+// Calcula o prefixo de comparação: os 8 primeiros bytes, em big-endian, completados com zeros
+uint64_t wordlookup_prefix(const char *word, size_t len)
+{
+    uint64_t prefix = 0;
+    memcpy(&prefix, word, len < 8 ? len : 8);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    prefix = __builtin_bswap64(prefix);
+#endif
+    return prefix;
+}
+
+// Reorganiza os nós ordenados no layout Eytzinger
+void wordlookup_layout(wordlookup_node *nodes, const wordlookup_node *sorted, size_t length)
+{
+    memset(&nodes[0], 0, sizeof(wordlookup_node));
+    layout_rec(nodes, sorted, length, 0, 1);
+}
+
+// Procura a palavra na árvore em layout Eytzinger
+size_t wordlookup_find(const wordlookup_node *nodes, size_t length, const char *words, size_t words_size,
+                       const char *word, size_t len)
+{
+    uint64_t prefix = wordlookup_prefix(word, len);
+
+    // Descida sem desvios: cada nível soma 0 (esquerda) ou 1 (direita) ao índice
+    size_t k = 1;
+    while (k <= length)
+    {
+        // Busca antecipada dos bisnetos e trinetos (4 níveis abaixo, 16 nós em 4 linhas de cache)
+        __builtin_prefetch(&nodes[16 * k]);
+        __builtin_prefetch(&nodes[16 * k + 4]);
+        __builtin_prefetch(&nodes[16 * k + 8]);
+        __builtin_prefetch(&nodes[16 * k + 12]);
+
+        const wordlookup_node *node = &nodes[k];
+        size_t less = node->prefix < prefix;
+        if (node->prefix == prefix && len >= 8)
+            less = tail_comp(node, words, words_size, word, len) > 0;
+        k = 2 * k + less;
+    }
+
+    // Desfaz os passos à direita do final da descida: 'k' passa a ser o primeiro nó >= palavra
+    k >>= __builtin_ffsll(~(unsigned long long)k);
+    if (k == 0 || nodes[k].prefix != prefix)
+        return WORDLOOKUP_NOT_FOUND;
+    if (len >= 8 && tail_comp(&nodes[k], words, words_size, word, len) != 0)
+        return WORDLOOKUP_NOT_FOUND;
+    return nodes[k].id;
+}
+
+// Cria a busca com as palavras da tabela, copiando-as em ordem alfabética para um único bloco
+wordlookup *wordlookup_create(wordmap *map)
+{
+    dynvec *entries = wordmap_entries(map);
+    size_t length = dynvec_length(entries);
+    size_t words_size = 0;
+    for (size_t i = 0; i < length; i++)
+        words_size += ((wordmap_entry *)dynvec_get(entries, i))->len + 1;
+    if (length > UINT32_MAX || words_size > UINT32_MAX)
+    {
+        errno = EOVERFLOW;
+        return NULL;
+    }
+
+    wordlookup *wl = malloc(sizeof(wordlookup));
+    const char **handles = malloc((length + 1) * sizeof(char *));
+    wordlookup_node *sorted = malloc((length + 1) * sizeof(wordlookup_node));
+    size_t nodes_size = ((length + 1) * sizeof(wordlookup_node) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    if (wl)
+    {
+        wl->nodes = aligned_alloc(CACHE_LINE, nodes_size);
+        wl->words = malloc(words_size + 1);
+        wl->times = malloc((length + 1) * sizeof(size_t));
+    }
+    if (!wl || !handles || !sorted || !wl->nodes || !wl->words || !wl->times)
+    {
+        free(handles);
+        free(sorted);
+        wordlookup_free(wl);
+        return NULL;
+    }
+    wl->length = length;
+    wl->words_size = words_size;
+
+    // Ordena as palavras; as contagens são buscadas de volta na tabela
+    for (size_t i = 0; i < length; i++)
+        handles[i] = ((wordmap_entry *)dynvec_get(entries, i))->word;
+    multikey_quicksort(handles, length);
+
+    size_t offset = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        size_t len = arena_len(handles[i]);
+        memcpy(wl->words + offset, handles[i], len + 1);
+        sorted[i] = (wordlookup_node){wordlookup_prefix(handles[i], len), (uint32_t)offset, (uint32_t)i};
+        wl->times[i] = wordmap_get(map, handles[i], len);
+        offset += len + 1;
+    }
+    wordlookup_layout(wl->nodes, sorted, length);
+
+    free(handles);
+    free(sorted);
+    return wl;
+}
+
+// Retorna a quantidade de aparições da palavra; se ela não existir, retorna 0
+size_t wordlookup_count(wordlookup *wl, const char *word, size_t len)
+{
+    size_t id = wordlookup_find(wl->nodes, wl->length, wl->words, wl->words_size, word, len);
+    return id == WORDLOOKUP_NOT_FOUND ? 0 : wl->times[id];
+}
+
+// Retorna a quantidade de palavras da estrutura
+size_t wordlookup_length(wordlookup *wl)
+{
+    return wl->length;
+}
+
+// Libera a memória da estrutura de busca
+void wordlookup_free(wordlookup *wl)
+{
+    if (wl)
+    {
+        free(wl->nodes);
+        free(wl->words);
+        free(wl->times);
+        free(wl);
+    }
+}
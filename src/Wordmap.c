@@ -0,0 +1,250 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <GenericDynvec.h>
+#include <Arena.h>
+#include <Stats.h>
+#include <Wordmap.h>
+
+// Posição da tabela de endereçamento aberto
+typedef struct Slot
+{
+    uint32_t tag;   // 32 bits mais altos do hash, para descartar colisões sem acessar a palavra
+    uint32_t index; // Índice da entrada em 'entries' mais 1 (0 indica posição vazia)
+} Slot;
+
+// Estrutura que representa a tabela de palavras (endereçamento aberto com sondagem linear)
+typedef struct Intwordmap
+{
+    Slot *slots;     // Posições da tabela
+    size_t capacity; // Quantidade de posições (potência de 2)
+    dynvec *entries; // Entradas (wordmap_entry), guardadas de forma contígua
+    arena *words;    // Arena onde as palavras distintas são guardadas
+} wordmap;
+
+/*-------------------------------------------------------
+   Funções auxiliares
+-------------------------------------------------------*/
+
+// Mistura final do hash, espalhando os bits de 'h'
+static inline uint64_t mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// Calcula o hash de uma palavra, consumindo 8 bytes por vez
+uint64_t wordmap_hash(const char *word, size_t len)
+{
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ len;
+    uint64_t k;
+
+    while (len >= 8)
+    {
+        memcpy(&k, word, 8);
+        h = (h ^ k) * 0x87c37b91114253d5ULL;
+        h ^= h >> 31;
+        word += 8;
+        len -= 8;
+    }
+    k = 0;
+    memcpy(&k, word, len);
+    return mix(h ^ k);
+}
+
+// Função auxiliar: procura a posição da palavra ou a primeira posição vazia da sua sequência de sondagem
+static Slot *find_slot(wordmap *map, const char *word, size_t len, uint64_t hash)
+{
+    size_t mask = map->capacity - 1;
+    uint32_t tag = (uint32_t)(hash >> 32);
+
+    for (size_t i = (size_t)hash & mask;; i = (i + 1) & mask)
+    {
+        Slot *slot = &map->slots[i];
+        if (slot->index == 0)
+            return slot;
+        if (slot->tag == tag)
+        {
+            wordmap_entry *entry = dynvec_get(map->entries, slot->index - 1);
+            if (entry->len == len && memcmp(entry->word, word, len) == 0)
+                return slot;
+        }
+    }
+}
+
+// Função auxiliar: dobra a capacidade da tabela, reposicionando as entradas existentes
+static bool wordmap_grow(wordmap *map)
+{
+    size_t new_capacity = map->capacity * 2;
+    Slot *new_slots = calloc(new_capacity, sizeof(Slot));
+    if (!new_slots)
+        return false;
+    STATS_INC(STATS_ALLOCATIONS);
+
+    size_t mask = new_capacity - 1;
+    for (size_t i = 0; i < map->capacity; i++)
+    {
+        Slot slot = map->slots[i];
+        if (slot.index == 0)
+            continue;
+        wordmap_entry *entry = dynvec_get(map->entries, slot.index - 1);
+        size_t j = (size_t)entry->hash & mask;
+        while (new_slots[j].index != 0)
+            j = (j + 1) & mask;
+        new_slots[j] = slot;
+    }
+
+    free(map->slots);
+    map->slots = new_slots;
+    map->capacity = new_capacity;
+    return true;
+}
+
+/*-------------------------------------------------------
+   Funções de manipulação da tabela de palavras (wordmap)
+-------------------------------------------------------*/
+
+// Cria e inicializa uma tabela de palavras vazia
+wordmap *wordmap_create(void)
+{
+    wordmap *map = malloc(sizeof(wordmap));
+    if (!map)
+        return NULL;
+
+    map->capacity = WORDMAP_INIT_CAPACITY;
+    map->slots = calloc(map->capacity, sizeof(Slot));
+    STATS_ADD(STATS_ALLOCATIONS, 2);
+    map->entries = dynvec_create(sizeof(wordmap_entry));
+    map->words = arena_create();
+    if (!map->slots || !map->entries || !map->words)
+    {
+        free(map->slots);
+        dynvec_free(map->entries);
+        arena_free(map->words);
+        free(map);
+        return NULL;
+    }
+    return map;
+}
+
+// Função auxiliar: soma 'times' às aparições da palavra cujo hash já foi calculado.
+// Retorna a entrada da palavra, ou NULL se faltar memória
+static wordmap_entry *add_hashed(wordmap *map, const char *word, size_t len, uint64_t hash, size_t times)
+{
+    Slot *slot = find_slot(map, word, len, hash);
+
+    // A palavra já existe: apenas atualiza a contagem no lugar
+    if (slot->index != 0)
+    {
+        wordmap_entry *existing = (wordmap_entry *)dynvec_get(map->entries, slot->index - 1);
+        existing->times += times;
+        return existing;
+    }
+
+    // Mantém a ocupação abaixo de 3/4 para que as sequências de sondagem fiquem curtas
+    if ((dynvec_length(map->entries) + 1) * 4 > map->capacity * 3)
+    {
+        if (!wordmap_grow(map))
+            return NULL;
+        slot = find_slot(map, word, len, hash);
+    }
+
+    wordmap_entry entry = {arena_store(map->words, word, len), len, times, hash};
+    if (!entry.word || !dynvec_push(map->entries, &entry))
+        return NULL;
+    slot->tag = (uint32_t)(hash >> 32);
+    slot->index = (uint32_t)dynvec_length(map->entries);
+    return (wordmap_entry *)dynvec_get(map->entries, slot->index - 1);
+}
+
+// Soma 'times' às aparições da palavra; se ela ainda não existir, é copiada para a tabela
+bool wordmap_add(wordmap *map, const char *word, size_t len, size_t times)
+{
+    return add_hashed(map, word, len, wordmap_hash(word, len), times) != NULL;
+}
+
+// Soma uma aparição à palavra e retorna a sua entrada, com o handle e o hash da palavra
+wordmap_entry *wordmap_intern(wordmap *map, const char *word, size_t len)
+{
+    return add_hashed(map, word, len, wordmap_hash(word, len), 1);
+}
+
+// Retorna a posição da entrada no vetor de entradas
+size_t wordmap_index(wordmap *map, const wordmap_entry *entry)
+{
+    return (size_t)(entry - (const wordmap_entry *)dynvec_get(map->entries, 0));
+}
+
+// Retorna a entrada 'index', cujas aparições podem ser alteradas
+wordmap_entry *wordmap_at(wordmap *map, size_t index)
+{
+    return (wordmap_entry *)dynvec_get(map->entries, index);
+}
+
+// Soma à tabela 'dest' as aparições de todas as palavras de 'src'
+bool wordmap_merge(wordmap *dest, wordmap *src)
+{
+    for (size_t i = 0; i < dynvec_length(src->entries); i++)
+    {
+        wordmap_entry *entry = dynvec_get(src->entries, i);
+        if (!add_hashed(dest, entry->word, entry->len, entry->hash, entry->times))
+            return false;
+    }
+    return true;
+}
+
+// Retorna a quantidade de aparições da palavra; se ela não existir, retorna 0
+size_t wordmap_get(wordmap *map, const char *word, size_t len)
+{
+    Slot *slot = find_slot(map, word, len, wordmap_hash(word, len));
+    if (slot->index == 0)
+        return 0;
+    return ((wordmap_entry *)dynvec_get(map->entries, slot->index - 1))->times;
+}
+
+// Retorna o número de palavras distintas guardadas na tabela
+size_t wordmap_length(wordmap *map)
+{
+    return dynvec_length(map->entries);
+}
+
+// Retorna a quantidade aproximada de bytes ocupados pela tabela
+size_t wordmap_memory(wordmap *map)
+{
+    return sizeof(wordmap) + map->capacity * sizeof(Slot) +
+           dynvec_capacity(map->entries) * sizeof(wordmap_entry) + arena_size(map->words);
+}
+
+// Compara duas entradas pela quantidade de aparições, desempatando pela palavra
+int wordmap_rank_comp(const void *key, const void *elem)
+{
+    const wordmap_entry *key_entry = (const wordmap_entry *)key;
+    const wordmap_entry *elem_entry = (const wordmap_entry *)elem;
+    if (key_entry->times != elem_entry->times)
+        return (key_entry->times > elem_entry->times) ? 1 : -1;
+    return strcmp(key_entry->word, elem_entry->word);
+}
+
+// Retorna o vetor com as entradas da tabela, na ordem de inserção
+dynvec *wordmap_entries(wordmap *map)
+{
+    return map->entries;
+}
+
+// Libera a memória alocada para a tabela e suas palavras
+void wordmap_free(wordmap *map)
+{
+    if (map)
+    {
+        dynvec_free(map->entries);
+        arena_free(map->words);
+        free(map->slots);
+        free(map);
+    }
+}
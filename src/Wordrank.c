@@ -0,0 +1,263 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <GenericDynvec.h>
+#include <Wordmap.h>
+#include <Stats.h>
+#include <Wordrank.h>
+
+// Heap indexado de entradas da tabela
+typedef struct Heap
+{
+    size_t *items;    // Índices das entradas
+    size_t length;    // Quantidade de entradas no heap
+    size_t capacity;  // Capacidade de 'items'
+    int order;        // 1: heap de mínimo (a menor na raiz); -1: heap de máximo
+    size_t *position; // Posição no heap mais 1 de cada entrada da tabela (0: fora do heap)
+} Heap;
+
+// Estrutura que representa o ranking incremental
+typedef struct Intwordrank
+{
+    wordmap *map;    // Tabela com as palavras e suas aparições
+    size_t n;        // Tamanho do ranking
+    Heap top;        // Heap de mínimo com as 'n' maiores entradas (a menor do ranking na raiz)
+    Heap rest;       // Heap de máximo com as demais entradas (só quando as aparições podem diminuir)
+    bool decreases;  // Indica se as aparições podem diminuir
+    size_t tracked;  // Quantidade de entradas da tabela com posição alocada nos heaps
+    dynvec *scratch; // Entradas do ranking com aparições, reaproveitado a cada consulta
+} wordrank;
+
+/*-------------------------------------------------------
+   Funções auxiliares
+-------------------------------------------------------*/
+
+// Função auxiliar: entrada 'index' da tabela
+static inline const wordmap_entry *entry_at(wordrank *wr, size_t index)
+{
+    return wordmap_at(wr->map, index);
+}
+
+// Função auxiliar: compara as entradas nas posições 'i' e 'j' do heap, na ordem do heap
+// (negativo quando a entrada 'i' deve ficar mais perto da raiz)
+static inline int heap_comp(wordrank *wr, Heap *h, size_t i, size_t j)
+{
+    return h->order * wordmap_rank_comp(entry_at(wr, h->items[i]), entry_at(wr, h->items[j]));
+}
+
+// Função auxiliar: troca duas posições do heap, atualizando as posições das entradas
+static inline void heap_swap(Heap *h, size_t i, size_t j)
+{
+    size_t temp = h->items[i];
+    h->items[i] = h->items[j];
+    h->items[j] = temp;
+    h->position[h->items[i]] = i + 1;
+    h->position[h->items[j]] = j + 1;
+}
+
+// Função auxiliar: sobe a entrada da posição 'i' enquanto ela vier antes do pai
+static void sift_up(wordrank *wr, Heap *h, size_t i)
+{
+    while (i > 0 && heap_comp(wr, h, i, (i - 1) / 2) < 0)
+    {
+        heap_swap(h, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+// Função auxiliar: desce a entrada da posição 'i' enquanto algum filho vier antes dela
+static void sift_down(wordrank *wr, Heap *h, size_t i)
+{
+    for (;;)
+    {
+        size_t first = i, left = 2 * i + 1, right = 2 * i + 2;
+        if (left < h->length && heap_comp(wr, h, left, first) < 0)
+            first = left;
+        if (right < h->length && heap_comp(wr, h, right, first) < 0)
+            first = right;
+        if (first == i)
+            return;
+        heap_swap(h, i, first);
+        i = first;
+    }
+}
+
+// Função auxiliar: insere a entrada no final do heap e a sobe. Retorna false se faltar memória
+static bool heap_push(wordrank *wr, Heap *h, size_t index)
+{
+    if (h->length == h->capacity)
+    {
+        size_t capacity = h->capacity ? h->capacity * 2 : WORDMAP_INIT_CAPACITY;
+        size_t *temp = realloc(h->items, capacity * sizeof(size_t));
+        if (!temp)
+            return false;
+        STATS_INC(STATS_ALLOCATIONS);
+        h->items = temp;
+        h->capacity = capacity;
+    }
+    h->items[h->length] = index;
+    h->position[index] = ++h->length;
+    sift_up(wr, h, h->length - 1);
+    return true;
+}
+
+// Função auxiliar: garante posições nos heaps para as entradas até 'index'
+static bool track(wordrank *wr, size_t index)
+{
+    if (index < wr->tracked)
+        return true;
+    size_t tracked = wr->tracked ? wr->tracked : WORDMAP_INIT_CAPACITY;
+    while (tracked <= index)
+        tracked *= 2;
+
+    Heap *heaps[2] = {&wr->top, &wr->rest};
+    for (int i = 0; i < (wr->decreases ? 2 : 1); i++)
+    {
+        size_t *temp = realloc(heaps[i]->position, tracked * sizeof(size_t));
+        if (!temp)
+            return false;
+        STATS_INC(STATS_ALLOCATIONS);
+        memset(temp + wr->tracked, 0, (tracked - wr->tracked) * sizeof(size_t));
+        heaps[i]->position = temp;
+    }
+    wr->tracked = tracked;
+    return true;
+}
+
+// Função auxiliar: enquanto a maior entrada fora do ranking passar a menor do ranking, troca as duas
+static void rebalance(wordrank *wr)
+{
+    while (wr->rest.length > 0 && wordmap_rank_comp(entry_at(wr, wr->rest.items[0]), entry_at(wr, wr->top.items[0])) > 0)
+    {
+        size_t in = wr->rest.items[0], out = wr->top.items[0];
+        wr->rest.position[in] = 0;
+        wr->top.position[out] = 0;
+        wr->top.items[0] = in;
+        wr->top.position[in] = 1;
+        wr->rest.items[0] = out;
+        wr->rest.position[out] = 1;
+        sift_down(wr, &wr->top, 0);
+        sift_down(wr, &wr->rest, 0);
+    }
+}
+
+/*-------------------------------------------------------
+   Funções do ranking incremental
+-------------------------------------------------------*/
+
+// Cria um ranking incremental das 'n' palavras mais usadas da tabela
+wordrank *wordrank_create(wordmap *map, size_t n, bool decreases)
+{
+    wordrank *wr = calloc(1, sizeof(wordrank));
+    if (!wr)
+        return NULL;
+    wr->map = map;
+    wr->n = n;
+    wr->decreases = decreases;
+    wr->top.order = 1;
+    wr->rest.order = -1;
+    wr->top.capacity = n;
+    wr->top.items = malloc((n > 0 ? n : 1) * sizeof(size_t));
+    STATS_INC(STATS_ALLOCATIONS);
+    wr->scratch = dynvec_create(sizeof(wordmap_entry));
+    if (!wr->top.items || !wr->scratch || !dynvec_reserve(wr->scratch, n))
+    {
+        wordrank_free(wr);
+        return NULL;
+    }
+    return wr;
+}
+
+// Reposiciona a entrada cujas aparições mudaram
+bool wordrank_update(wordrank *wr, const wordmap_entry *entry)
+{
+    if (wr->n == 0)
+        return true;
+    size_t index = wordmap_index(wr->map, entry);
+    if (!track(wr, index))
+        return false;
+
+    size_t pos = wr->top.position[index];
+    if (pos != 0)
+    {
+        // Já está no ranking: a entrada desce no heap de mínimo se aumentou, ou sobe se diminuiu
+        // (e pode passar a ser menor que a maior entrada de fora)
+        sift_up(wr, &wr->top, pos - 1);
+        sift_down(wr, &wr->top, wr->top.position[index] - 1);
+        if (wr->decreases)
+            rebalance(wr);
+    }
+    else if (wr->top.length < wr->n)
+    {
+        wr->top.items[wr->top.length] = index;
+        wr->top.position[index] = ++wr->top.length;
+        sift_up(wr, &wr->top, wr->top.length - 1);
+    }
+    else if (wr->decreases)
+    {
+        // Fora do ranking: a entrada é reposicionada no heap de máximo e pode passar a menor do ranking
+        pos = wr->rest.position[index];
+        if (pos == 0)
+        {
+            if (!heap_push(wr, &wr->rest, index))
+                return false;
+        }
+        else
+        {
+            sift_up(wr, &wr->rest, pos - 1);
+            sift_down(wr, &wr->rest, wr->rest.position[index] - 1);
+        }
+        rebalance(wr);
+    }
+    else if (wordmap_rank_comp(entry, entry_at(wr, wr->top.items[0])) > 0)
+    {
+        // Passou a menor palavra do ranking: toma o lugar dela na raiz. Como as contagens só aumentam,
+        // as palavras fora do ranking nunca passam da raiz sem serem atualizadas
+        wr->top.position[wr->top.items[0]] = 0;
+        wr->top.items[0] = index;
+        wr->top.position[index] = 1;
+        sift_down(wr, &wr->top, 0);
+    }
+    return true;
+}
+
+// Retorna um novo vetor com as palavras do ranking, da mais usada para a menos usada
+dynvec *wordrank_top(wordrank *wr)
+{
+    dynvec *top = dynvec_create(sizeof(wordmap_entry));
+    if (top && !wordrank_top_into(wr, top))
+    {
+        dynvec_free(top);
+        return NULL;
+    }
+    return top;
+}
+
+// Escreve em 'out' as palavras do ranking, da mais usada para a menos usada
+bool wordrank_top_into(wordrank *wr, dynvec *out)
+{
+    // O vetor auxiliar tem capacidade reservada para 'n' entradas: nenhum push realoca
+    dynvec_clear(wr->scratch);
+    for (size_t i = 0; i < wr->top.length; i++)
+    {
+        // Palavras que saíram de todas as janelas continuam na tabela, sem nenhuma aparição
+        const wordmap_entry *entry = entry_at(wr, wr->top.items[i]);
+        if (entry->times > 0)
+            dynvec_push(wr->scratch, (void *)entry);
+    }
+    return dynvec_top_k_into(wr->scratch, dynvec_length(wr->scratch), wordmap_rank_comp, out);
+}
+
+// Libera a memória do ranking
+void wordrank_free(wordrank *wr)
+{
+    if (!wr)
+        return;
+    free(wr->top.items);
+    free(wr->top.position);
+    free(wr->rest.items);
+    free(wr->rest.position);
+    dynvec_free(wr->scratch);
+    free(wr);
+}
@@ -0,0 +1,395 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <GenericDynvec.h>
+#include <SpaceSaving.h>
+#include <Tokenizer.h>
+
+#define TEST_BOOK "padre_amaro.txt" // Livro utilizado nas verificações do tokenizador
+
+// Núcleos de classificação comparados com o escalar
+static const char *kernels[] = {"sse2", "avx2"};
+
+// Palavra encontrada pelo tokenizador, como posição no buffer
+typedef struct Span
+{
+    size_t offset;
+    size_t len;
+} span;
+
+// Quantidade de verificações que falharam
+static int failures = 0;
+
+// Estado do comparador adversário (McIlroy, "A Killer Adversary for Quicksort"): os valores
+// só são decididos durante a ordenação, sempre de forma a desequilibrar as partições
+static size_t *adversary_value;
+static size_t adversary_gas, adversary_solid, adversary_candidate, adversary_comparisons;
+
+// Compara dois índices, fixando o valor de um deles quando os dois ainda estão indefinidos
+static inline int adversary_cmp(const size_t *a, const size_t *b)
+{
+    size_t x = *a, y = *b;
+    adversary_comparisons++;
+    if (adversary_value[x] == adversary_gas && adversary_value[y] == adversary_gas)
+        adversary_value[(x == adversary_candidate) ? x : y] = adversary_solid++;
+    if (adversary_value[x] == adversary_gas)
+        adversary_candidate = x;
+    else if (adversary_value[y] == adversary_gas)
+        adversary_candidate = y;
+    return (adversary_value[x] > adversary_value[y]) - (adversary_value[x] < adversary_value[y]);
+}
+
+DYNVEC_DEFINE(size_t, index_vec)
+DYNVEC_DEFINE_SORT(size_t, index_vec, adversary_cmp)
+
+// Compara strings para o qsort
+static int string_cmp(const void *a, const void *b)
+{
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+// Registra o resultado de uma verificação, imprimindo a mensagem quando ela falha
+static void check(bool ok, const char *name, const char *message)
+{
+    if (!ok)
+    {
+        printf("FALHOU  %-24s %s\n", name, message);
+        failures++;
+    }
+}
+
+/*-------------------------------------------------------
+   Funções auxiliares
+-------------------------------------------------------*/
+
+// Procura a palavra entre as 'n' de maior estimativa. Retorna false se ela não estiver lá
+static bool spacesaving_find(spacesaving *ss, size_t n, const char *word, spacesaving_item *found)
+{
+    dynvec *top = spacesaving_top(ss, n);
+    bool ok = false;
+    for (size_t i = 0; top && i < dynvec_length(top); i++)
+    {
+        spacesaving_item *item = (spacesaving_item *)dynvec_get(top, i);
+        if (strcmp(item->word, word) == 0)
+        {
+            *found = *item;
+            ok = true;
+        }
+    }
+    dynvec_free(top);
+    return ok;
+}
+
+// Registra a palavra 'word' 'times' vezes
+static bool spacesaving_add_times(spacesaving *ss, const char *word, size_t times)
+{
+    for (size_t i = 0; i < times; i++)
+    {
+        if (!spacesaving_add(ss, word, strlen(word)))
+            return false;
+    }
+    return true;
+}
+
+// Tokeniza o buffer com o núcleo 'kernel', retornando um vetor com a posição e o tamanho de cada palavra
+static dynvec *tokenize_spans(const char *kernel, const char *data, size_t size)
+{
+    if (!tokenizer_set_kernel(kernel))
+        return NULL;
+    tokenizer *tk = tokenizer_open_buffer(data, size);
+    dynvec *spans = dynvec_create(sizeof(span));
+    if (!tk || !spans)
+    {
+        tokenizer_close(tk);
+        dynvec_free(spans);
+        return NULL;
+    }
+    token tok;
+    while (tokenizer_next(tk, &tok))
+    {
+        span item = {(size_t)(tok.ptr - data), tok.len};
+        if (!dynvec_push(spans, &item))
+        {
+            dynvec_free(spans);
+            spans = NULL;
+            break;
+        }
+    }
+    tokenizer_close(tk);
+    return spans;
+}
+
+// Compara as palavras do núcleo 'kernel' com as do núcleo escalar, palavra por palavra.
+// Retorna false (e imprime a primeira diferença) se elas forem diferentes
+static bool compare_kernel(const char *kernel, const char *data, size_t size, const char *label)
+{
+    dynvec *expected = tokenize_spans("scalar", data, size);
+    dynvec *got = tokenize_spans(kernel, data, size);
+    bool ok = expected && got;
+    size_t n = ok ? dynvec_length(expected) : 0;
+    for (size_t i = 0; ok && i < n && i < dynvec_length(got); i++)
+    {
+        span *a = (span *)dynvec_get(expected, i), *b = (span *)dynvec_get(got, i);
+        if (a->offset != b->offset || a->len != b->len)
+        {
+            printf("FALHOU  %-24s %s (%s): palavra %zu em (%zu, %zu), esperado (%zu, %zu)\n", "tokenizer", label, kernel,
+                   i, b->offset, b->len, a->offset, a->len);
+            ok = false;
+        }
+    }
+    if (ok && dynvec_length(got) != n)
+    {
+        printf("FALHOU  %-24s %s (%s): %zu palavras, esperado %zu\n", "tokenizer", label, kernel, dynvec_length(got), n);
+        ok = false;
+    }
+    dynvec_free(expected);
+    dynvec_free(got);
+    return ok;
+}
+
+// Carrega o arquivo inteiro em memória. Retorna NULL se não for possível
+static char *load_file(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+        return NULL;
+    char *data = NULL;
+    if (fseek(file, 0, SEEK_END) == 0)
+    {
+        long length = ftell(file);
+        rewind(file);
+        data = (length >= 0) ? malloc((size_t)length + 1) : NULL;
+        if (data && fread(data, 1, (size_t)length, file) != (size_t)length)
+        {
+            free(data);
+            data = NULL;
+        }
+        *size = (size_t)length;
+    }
+    fclose(file);
+    return data;
+}
+
+/*-------------------------------------------------------
+   Verificações
+-------------------------------------------------------*/
+
+// Tokenizador: os núcleos SSE2 e AVX2 encontram exatamente as mesmas palavras que o escalar,
+// no livro e em palavras que atravessam os blocos de 16 e 32 bytes ou terminam junto com a entrada
+static void test_tokenizer_kernels(void)
+{
+    const char *name = "tokenizer";
+    const char *initial = tokenizer_kernel();
+    size_t size;
+    char *book = load_file(TEST_BOOK, &size);
+    check(book != NULL, name, "não foi possível ler " TEST_BOOK);
+
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++)
+    {
+        if (!tokenizer_set_kernel(kernels[k]))
+        {
+            printf("-       %-24s núcleo %s não suportado pelo processador\n", name, kernels[k]);
+            continue;
+        }
+        if (book && !compare_kernel(kernels[k], book, size, TEST_BOOK))
+            failures++;
+
+        // Palavra de 'len' bytes começando em 'start', seguida de 'tail' separadores: cobre palavras
+        // que atravessam os blocos e palavras no fim da entrada (tail = 0). Os bytes >= 128 (UTF-8)
+        // também são letras. Cada buffer tem o tamanho exato, para que leituras além do fim apareçam.
+        bool ok = true;
+        for (size_t start = 0; ok && start <= 40; start++)
+        {
+            for (size_t len = 1; ok && len <= 70; len++)
+            {
+                for (size_t tail = 0; ok && tail <= 2; tail++)
+                {
+                    size_t total = start + len + tail;
+                    char *data = malloc(total);
+                    if (!data)
+                    {
+                        check(false, name, "malloc");
+                        ok = false;
+                        break;
+                    }
+                    for (size_t i = 0; i < total; i++)
+                        data[i] = (i % 7 == 3) ? '\n' : ' ';
+                    for (size_t i = 0; i < len; i++)
+                        data[start + i] = (i % 5 == 4) ? (char)0xC3 : (char)('a' + i % 26);
+                    char label[64];
+                    snprintf(label, sizeof(label), "start=%zu len=%zu tail=%zu", start, len, tail);
+                    ok = compare_kernel(kernels[k], data, total, label);
+                    free(data);
+                }
+            }
+        }
+        if (!ok)
+            failures++;
+    }
+    free(book);
+    tokenizer_set_kernel(initial);
+}
+// Tokenizador: um arquivo vazio está inteiro em memória (buffer vazio), não é lido em blocos
+static void test_tokenizer_empty(void)
+{
+    const char *name = "tokenizer";
+    char path[] = "/tmp/ranking_testXXXXXX";
+    int fd = mkstemp(path);
+    check(fd >= 0, name, "mkstemp");
+    if (fd < 0)
+        return;
+    close(fd);
+    tokenizer *tk = tokenizer_open(path);
+    size_t size = 1;
+    token tok;
+    check(tk && tokenizer_buffer(tk, &size) != NULL && size == 0, name, "arquivo vazio sem buffer");
+    check(tk && !tokenizer_next(tk, &tok) && !tokenizer_error(tk), name, "arquivo vazio com palavras ou erro");
+    tokenizer_close(tk);
+    unlink(path);
+}
+
+// Sort especializado: contra o comparador adversário, o limite de profundidade troca o quicksort
+// pelo heapsort e o número de comparações fica O(n log n) em vez de O(n²)
+static void test_typed_sort(void)
+{
+    const char *name = "typed sort";
+    size_t n = 20000, log_n = 0;
+    for (size_t m = n; m > 1; m >>= 1)
+        log_n++;
+    index_vec *vec = index_vec_create();
+    adversary_value = malloc(n * sizeof(size_t));
+    bool ok = vec && adversary_value;
+    for (size_t i = 0; ok && i < n; i++)
+    {
+        adversary_value[i] = n;
+        ok = index_vec_push(vec, i);
+    }
+    check(ok, name, "malloc");
+    if (ok)
+    {
+        adversary_gas = n;
+        adversary_solid = 0;
+        adversary_comparisons = 0;
+        index_vec_sort(vec);
+        for (size_t i = 1; i < n; i++)
+        {
+            if (adversary_value[vec->data[i - 1]] > adversary_value[vec->data[i]])
+            {
+                check(false, name, "vetor fora de ordem");
+                break;
+            }
+        }
+        char message[96];
+        snprintf(message, sizeof(message), "%zu comparações para %zu elementos", adversary_comparisons, n);
+        check(adversary_comparisons <= 8 * n * log_n, name, message);
+    }
+    index_vec_free(vec);
+    free(adversary_value);
+}
+
+// Multikey quicksort: mesma ordem que o strcmp, com prefixos comuns, repetições e strings vazias
+static void test_multikey(void)
+{
+    const char *name = "multikey";
+    size_t n = 5000;
+    char (*pool)[8] = malloc(n * sizeof(*pool));
+    const char **got = malloc(n * sizeof(char *)), **expected = malloc(n * sizeof(char *));
+    if (!pool || !got || !expected)
+        check(false, name, "malloc");
+    else
+    {
+        uint64_t state = 88172645463325252ULL;
+        for (size_t i = 0; i < n; i++)
+        {
+            // Até 7 letras entre 'a' e 'c': muitos prefixos comuns e repetições
+            state ^= state << 13, state ^= state >> 7, state ^= state << 17;
+            size_t len = state % 8;
+            for (size_t j = 0; j < len; j++)
+                pool[i][j] = (char)('a' + (state >> (8 + 2 * j)) % 3);
+            pool[i][len] = '\0';
+            got[i] = expected[i] = pool[i];
+        }
+        multikey_quicksort(got, n);
+        qsort(expected, n, sizeof(char *), string_cmp);
+        for (size_t i = 0; i < n; i++)
+        {
+            if (strcmp(got[i], expected[i]) != 0)
+            {
+                check(false, name, "ordem diferente da do strcmp");
+                break;
+            }
+        }
+    }
+    free(pool);
+    free(got);
+    free(expected);
+}
+
+// Space-Saving: uma palavra frequente registrada enquanto ainda há contadores livres não é
+// substituída quando os contadores acabam
+static void test_spacesaving(void)
+{
+    const char *name = "spacesaving";
+    spacesaving *ss = spacesaving_create(0, false); // Orçamento mínimo: MIN_COUNTERS contadores
+    if (!ss)
+    {
+        check(false, name, "spacesaving_create");
+        return;
+    }
+    size_t capacity = spacesaving_capacity(ss);
+    char word[32];
+    spacesaving_item item;
+
+    // "x" cresce antes de os outros contadores serem ocupados; "new" ocupa o lugar do menor
+    bool ok = spacesaving_add_times(ss, "x", 10);
+    for (size_t i = 1; ok && i < capacity; i++)
+    {
+        snprintf(word, sizeof(word), "w%zu", i);
+        ok = spacesaving_add_times(ss, word, 1);
+    }
+    ok = ok && spacesaving_add_times(ss, "new", 1);
+    check(ok, name, "spacesaving_add");
+    check(spacesaving_find(ss, capacity, "x", &item) && item.count == 10 && item.error == 0, name,
+          "\"x\" (10 aparições) foi substituída");
+    check(spacesaving_find(ss, capacity, "new", &item) && item.count == 2 && item.error == 1, name,
+          "\"new\" deveria ter estimativa 2 com erro 1");
+    spacesaving_free(ss);
+
+    // Uma palavra com 'capacity' aparições nunca é substituída enquanto o total de palavras é
+    // menor que capacity², já que a menor estimativa é no máximo total / capacity
+    ss = spacesaving_create(0, false);
+    ok = ss && spacesaving_add_times(ss, "x", capacity);
+    for (size_t i = 0; ok && i < capacity * (capacity - 1) - 1; i++)
+    {
+        snprintf(word, sizeof(word), "w%zu", i);
+        ok = spacesaving_add_times(ss, word, 1);
+        if (ok && !spacesaving_find(ss, capacity, "x", &item))
+        {
+            check(false, name, "\"x\" (capacity aparições) foi substituída");
+            break;
+        }
+    }
+    check(ok, name, "spacesaving_add");
+    check(ok && spacesaving_find(ss, capacity, "x", &item) && item.count == capacity && item.error == 0, name,
+          "\"x\" deveria ter contagem exata 'capacity'");
+    spacesaving_free(ss);
+}
+
+int main(void)
+{
+    test_typed_sort();
+    test_multikey();
+    test_spacesaving();
+    test_tokenizer_kernels();
+    test_tokenizer_empty();
+    if (failures > 0)
+    {
+        printf("%d verificações falharam\n", failures);
+        return 1;
+    }
+    printf("Todas as verificações passaram\n");
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Gera as tabelas do tokenizador com normalização (--fold), escritas na saída padrão como
+ * um header C. Executado pelo makefile durante a compilação (obj/TokenizerTables.h).
+ *
+ * O autômato lê um byte por vez. Cada byte tem uma classe:
+ *   DELIM  separador (inclusive bytes de caracteres UTF-8 que não são letras)
+ *   LETTER letra ASCII
+ *   LEAD   0xC3, primeiro byte dos caracteres U+00C0 a U+00FF
+ *   LATIN1 segundo byte de uma letra entre U+00C0 e U+00FF (À a ÿ, sem × e ÷)
+ * e cada par (estado, classe) indica o próximo estado e a ação a ser feita com o byte.
+ */
+
+// Estados do autômato
+enum
+{
+    OUT,      // Entre palavras
+    IN,       // Dentro de uma palavra
+    OUT_LEAD, // Leu 0xC3 entre palavras
+    IN_LEAD,  // Leu 0xC3 dentro de uma palavra
+    STATES
+};
+
+// Classes de bytes
+enum
+{
+    DELIM,
+    LETTER,
+    LEAD,
+    LATIN1,
+    CLASSES
+};
+
+// Ações
+enum
+{
+    NONE,          // Só muda de estado
+    APPEND,        // Acrescenta à palavra o byte convertido para minúscula
+    APPEND_LATIN1, // Acrescenta 0xC3 e o segundo byte convertido para minúscula
+    END,           // A palavra terminou antes deste byte, que é consumido
+    END_KEEP       // A palavra terminou antes deste byte, que é lido de novo no próximo estado
+};
+
+// Bits do estado em cada entrada da tabela de transições (a ação fica nos bits acima)
+#define STATE_BITS 2
+
+// Verifica se o código Unicode entre U+00C0 e U+00FF é uma letra (× e ÷ não são)
+static bool is_latin1_letter(unsigned cp)
+{
+    return cp >= 0xC0 && cp <= 0xFF && cp != 0xD7 && cp != 0xF7;
+}
+
+// Minúscula de uma letra ASCII ou Latin-1 (ß e ÿ não têm maiúscula neste intervalo)
+static unsigned to_lower(unsigned cp)
+{
+    if ((cp >= 'A' && cp <= 'Z') || (cp >= 0xC0 && cp <= 0xDE && cp != 0xD7))
+        return cp + 0x20;
+    return cp;
+}
+
+int main(void)
+{
+    uint8_t class[256] = {0};
+    uint8_t fold[256] = {0};
+
+    for (unsigned b = 'A'; b <= 'Z'; b++)
+    {
+        class[b] = class[b + 0x20] = LETTER;
+        fold[b] = fold[b + 0x20] = (uint8_t)to_lower(b + 0x20);
+    }
+    class[0xC3] = LEAD;
+
+    // U+00C0 a U+00FF são codificados como 0xC3 seguido de 0x80 + (cp - 0xC0)
+    for (unsigned cp = 0xC0; cp <= 0xFF; cp++)
+    {
+        unsigned second = 0x80 | (cp & 0x3F);
+        if (is_latin1_letter(cp))
+        {
+            class[second] = LATIN1;
+            fold[second] = (uint8_t)(0x80 | (to_lower(cp) & 0x3F));
+        }
+    }
+
+    static const struct
+    {
+        uint8_t state, action;
+    } next[STATES][CLASSES] = {
+        [OUT] = {[DELIM] = {OUT, NONE}, [LETTER] = {IN, APPEND}, [LEAD] = {OUT_LEAD, NONE}, [LATIN1] = {OUT, NONE}},
+        [IN] = {[DELIM] = {OUT, END}, [LETTER] = {IN, APPEND}, [LEAD] = {IN_LEAD, NONE}, [LATIN1] = {OUT, END}},
+        [OUT_LEAD] = {[DELIM] = {OUT, NONE}, [LETTER] = {IN, APPEND}, [LEAD] = {OUT_LEAD, NONE}, [LATIN1] = {IN, APPEND_LATIN1}},
+        [IN_LEAD] = {[DELIM] = {OUT, END}, [LETTER] = {OUT, END_KEEP}, [LEAD] = {OUT_LEAD, END}, [LATIN1] = {IN, APPEND_LATIN1}},
+    };
+
+    printf("/* Gerado por tools/TokenizerTables.c: não edite */\n");
+    printf("#ifndef TOKENIZER_TABLES_H\n#define TOKENIZER_TABLES_H\n\n#include <stdint.h>\n\n");
+    printf("#define FOLD_OUT %d\n#define FOLD_IN %d\n#define FOLD_OUT_LEAD %d\n#define FOLD_IN_LEAD %d\n",
+           OUT, IN, OUT_LEAD, IN_LEAD);
+    printf("#define FOLD_NONE %d\n#define FOLD_APPEND %d\n#define FOLD_APPEND_LATIN1 %d\n#define FOLD_END %d\n#define FOLD_END_KEEP %d\n",
+           NONE, APPEND, APPEND_LATIN1, END, END_KEEP);
+    printf("#define FOLD_DELIM %d\n#define FOLD_LETTER %d\n#define FOLD_LEAD %d\n#define FOLD_LATIN1 %d\n",
+           DELIM, LETTER, LEAD, LATIN1);
+    printf("#define FOLD_STATE_BITS %d\n#define FOLD_STATE_MASK %d\n#define FOLD_CLASSES %d\n\n",
+           STATE_BITS, (1 << STATE_BITS) - 1, CLASSES);
+
+    printf("/* Classe de cada byte */\nstatic const uint8_t fold_class[256] = {");
+    for (int b = 0; b < 256; b++)
+        printf("%s%d,", (b % 32) ? "" : "\n    ", class[b]);
+    printf("\n};\n\n");
+
+    printf("/* Byte convertido para minúscula (letras ASCII e segundos bytes das letras Latin-1) */\nstatic const uint8_t fold_byte[256] = {");
+    for (int b = 0; b < 256; b++)
+        printf("%s0x%02x,", (b % 16) ? "" : "\n    ", fold[b]);
+    printf("\n};\n\n");
+
+    printf("/* Transições: (ação << FOLD_STATE_BITS) | próximo estado */\nstatic const uint8_t fold_next[%d][FOLD_CLASSES] = {\n", STATES);
+    for (int s = 0; s < STATES; s++)
+    {
+        printf("    {");
+        for (int c = 0; c < CLASSES; c++)
+            printf("%s%d", c ? ", " : "", (next[s][c].action << STATE_BITS) | next[s][c].state);
+        printf("},\n");
+    }
+    printf("};\n\n#endif /* TOKENIZER_TABLES_H */\n");
+    return 0;
+}